@@ -0,0 +1,46 @@
+#ifndef DEADLINE_H
+#define DEADLINE_H
+
+#include <chrono>
+
+/**
+ * @brief Per-request latency budget
+ * @note  A default constructed Deadline is unbounded (never expires).
+ */
+class Deadline {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // unbounded deadline
+    Deadline(): expiry(Clock::time_point::max()), bounded(false) {}
+
+    // deadline = now + budget
+    explicit Deadline(std::chrono::milliseconds budget)
+        : expiry(Clock::now() + budget), bounded(true) {}
+
+    bool isBounded() const {return bounded;}
+
+    // true once the budget is used up
+    bool expired() const {
+        return bounded && Clock::now() >= expiry;
+    }
+
+    // remaining budget in milliseconds (0 when expired)
+    // Note: returns a very large value for unbounded deadlines
+    double remainingMs() const {
+        if(!bounded){
+            return std::chrono::duration<double, std::milli>::max().count();
+        }
+
+        auto now = Clock::now();
+        if(now >= expiry){
+            return 0.0;
+        }
+        return std::chrono::duration<double, std::milli>(expiry - now).count();
+    }
+
+private:
+    Clock::time_point expiry;
+    bool bounded;
+};
+#endif // DEADLINE_H
@@ -1,7 +1,34 @@
 import gradio as gr
+import base64
+import json
 import os
+import urllib.request
 
-def KAI(input_image, options, MLConfig, facialImgDir):
+# KAI HTTP endpoint (KAI-impl -serve <port> <json_path>)
+# when set, images are sent to the resident server instead of spawning KAI-impl
+KAI_SERVER_URL = os.environ.get("KAI_SERVER_URL", "")
+
+def KAI_server(input_image, output_img, outputs):
+    with open(input_image, "rb") as f:
+        body = f.read()
+
+    ext = "png" if output_img.endswith(".png") else "jpg"
+    query = "landmarks=0&overlay=" + ext
+    if outputs:
+        query += "&tasks=" + ",".join(outputs)
+    request = urllib.request.Request(KAI_SERVER_URL + "/process?" + query,
+                                     data=body, method="POST",
+                                     headers={"Content-Type": "application/octet-stream"})
+    with urllib.request.urlopen(request) as response:
+        results = json.loads(response.read())
+
+    print(json.dumps({k: v for k, v in results.items() if k != "overlay"}))
+    with open(output_img, "wb") as f:
+        f.write(base64.b64decode(results["overlay"]))
+
+    return output_img
+
+def KAI(input_image, options, outputs, MLConfig, facialImgDir):
     print(input_image)
     # create output_img variable by adding KPT to the end of the input_img which could be jpg, jpeg, or png
     if input_image.endswith(".jpg"):
@@ -13,6 +40,9 @@ def KAI(input_image, options, MLConfig, facialImgDir):
     elif input_image.endswith(".tif"):
         output_img = input_image.replace(".tif", "_KAI.tif")
     print(output_img)
+
+    if KAI_SERVER_URL:
+        return KAI_server(input_image, output_img, outputs)
     
     checked_options = []
     # Iterate through the options and add them to the list
@@ -20,6 +50,10 @@ def KAI(input_image, options, MLConfig, facialImgDir):
         checked_options.append(option)
         if option == "-facialImgDir":
             checked_options.append(facialImgDir)
+
+    # compute the selected outputs only (none selected: all tasks of the MLConfig)
+    if outputs:
+        checked_options.append("-tasks " + ",".join(outputs))
     
     # Join the options with space
     checked_options_str = " ".join(checked_options)
@@ -43,6 +77,8 @@ demo = gr.Interface(
     inputs = [gr.Image(type="filepath"), 
         gr.CheckboxGroup(["-facialImgDir", "-MLConfig"],
         label = "KAI Options"),
+        gr.CheckboxGroup(["FaceDetection", "FacialFeatures", "FacePose", "MouthOpen", "Smile", "Eyeglasses"],
+        label = "Outputs (none: all tasks)"),
         gr.Textbox(label = "(required) Path to ML Task Configuration File"),
         gr.Textbox(label = "(optional) Path to Facial Imaging library")
     ],
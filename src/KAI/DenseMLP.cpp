@@ -0,0 +1,311 @@
+#include "DenseMLP.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <random>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// round up to a multiple of 8 floats (one AVX register)
+int padTo8(int n) {
+    return (n + 7) & ~7;
+}
+
+#if defined(__AVX__)
+inline __m256 mulAdd(__m256 a, __m256 b, __m256 c) {
+#if defined(__FMA__)
+    return _mm256_fmadd_ps(a, b, c);
+#else
+    return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+#endif
+}
+
+inline float horizontalSum(__m256 v) {
+    __m128 sum = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    sum = _mm_hadd_ps(sum, sum);
+    sum = _mm_hadd_ps(sum, sum);
+    return _mm_cvtss_f32(sum);
+}
+#endif
+
+// dot products of one weight row <w> with 4 input rows
+// n: padded row length (multiple of 8), rows are 32-byte aligned
+inline void dot4(const float* w, const float* x0, const float* x1,
+                 const float* x2, const float* x3, int n, float* out) {
+#if defined(__AVX__)
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    __m256 acc2 = _mm256_setzero_ps();
+    __m256 acc3 = _mm256_setzero_ps();
+    for (int k = 0; k < n; k += 8) {
+        __m256 wv = _mm256_load_ps(w + k);
+        acc0 = mulAdd(wv, _mm256_load_ps(x0 + k), acc0);
+        acc1 = mulAdd(wv, _mm256_load_ps(x1 + k), acc1);
+        acc2 = mulAdd(wv, _mm256_load_ps(x2 + k), acc2);
+        acc3 = mulAdd(wv, _mm256_load_ps(x3 + k), acc3);
+    }
+    out[0] = horizontalSum(acc0);
+    out[1] = horizontalSum(acc1);
+    out[2] = horizontalSum(acc2);
+    out[3] = horizontalSum(acc3);
+#else
+    // 8 independent accumulators per row (auto-vectorized by the compiler)
+    float acc[4][8] = {};
+    for (int k = 0; k < n; k += 8) {
+        for (int l = 0; l < 8; ++l) {
+            acc[0][l] += w[k + l] * x0[k + l];
+            acc[1][l] += w[k + l] * x1[k + l];
+            acc[2][l] += w[k + l] * x2[k + l];
+            acc[3][l] += w[k + l] * x3[k + l];
+        }
+    }
+    for (int r = 0; r < 4; ++r) {
+        float sum = 0.0f;
+        for (int l = 0; l < 8; ++l) {
+            sum += acc[r][l];
+        }
+        out[r] = sum;
+    }
+#endif
+}
+
+inline float dot1(const float* w, const float* x, int n) {
+#if defined(__AVX__)
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    int k = 0;
+    for (; k + 16 <= n; k += 16) {
+        acc0 = mulAdd(_mm256_load_ps(w + k), _mm256_load_ps(x + k), acc0);
+        acc1 = mulAdd(_mm256_load_ps(w + k + 8), _mm256_load_ps(x + k + 8), acc1);
+    }
+    for (; k < n; k += 8) {
+        acc0 = mulAdd(_mm256_load_ps(w + k), _mm256_load_ps(x + k), acc0);
+    }
+    return horizontalSum(_mm256_add_ps(acc0, acc1));
+#else
+    float acc[8] = {};
+    for (int k = 0; k < n; k += 8) {
+        for (int l = 0; l < 8; ++l) {
+            acc[l] += w[k + l] * x[k + l];
+        }
+    }
+    float sum = 0.0f;
+    for (int l = 0; l < 8; ++l) {
+        sum += acc[l];
+    }
+    return sum;
+#endif
+}
+
+} // namespace
+
+bool DenseMLP::loadFromNet(cv::dnn::Net& net, const std::string& outputName, int inputSize)
+{
+    layers.clear();
+
+    int prevOut = inputSize;
+    for (const auto& name : net.getLayerNames()) {
+        
+        cv::Ptr<cv::dnn::Layer> layer = net.getLayer(net.getLayerId(name));
+        const std::string& type = layer->type;
+
+        if (type == "InnerProduct") {
+            if (layer->blobs.empty() || layer->blobs[0].depth() != CV_32F) {
+                layers.clear();
+                return false;
+            }
+
+            // OpenCV stores weights as [out x in]; also accept [in x out]
+            const cv::Mat& blob = layer->blobs[0];
+            cv::Mat W = blob.reshape(1, blob.size[0]);
+
+            bool transposed = false;
+            if (W.cols == prevOut) {
+                transposed = false;
+            }
+            else if (W.rows == prevOut) {
+                transposed = true;
+            }
+            else {
+                layers.clear();
+                return false;
+            }
+
+            DenseLayer dense;
+            dense.in = prevOut;
+            dense.out = transposed ? W.cols : W.rows;
+            dense.stride = padTo8(dense.in);
+
+            // row-major [out x stride], zero padded
+            dense.weights.resize(static_cast<size_t>(dense.out) * dense.stride);
+            std::fill(dense.weights.data(), dense.weights.data() + dense.weights.size(), 0.0f);
+            for (int j = 0; j < dense.out; ++j) {
+                float* row = dense.weights.data() + static_cast<size_t>(j) * dense.stride;
+                for (int k = 0; k < dense.in; ++k) {
+                    row[k] = transposed ? W.at<float>(k, j) : W.at<float>(j, k);
+                }
+            }
+
+            // bias (if any)
+            dense.bias.assign(dense.out, 0.0f);
+            if (layer->blobs.size() > 1 && layer->blobs[1].total() == static_cast<size_t>(dense.out)) {
+                const float* b = layer->blobs[1].ptr<float>();
+                std::copy(b, b + dense.out, dense.bias.begin());
+            }
+
+            prevOut = dense.out;
+            layers.push_back(std::move(dense));
+        }
+        else if (type == "ReLU" || type == "Sigmoid" || type == "TanH") {
+            // activation must follow a dense layer
+            if (layers.empty() || layers.back().act != ActNone) {
+                layers.clear();
+                return false;
+            }
+
+            layers.back().act = (type == "ReLU") ? ActReLU : (type == "Sigmoid") ? ActSigmoid : ActTanH;
+        }
+        else if (type == "Identity" || type == "Dropout" || type == "Flatten" || type == "Reshape") {
+            // shape-only layers (inputs are already flat vectors)
+        }
+        else {
+            // unsupported layer
+            layers.clear();
+            return false;
+        }
+
+        if (name == outputName) {
+            break;
+        }
+    }
+
+    return !layers.empty();
+}
+
+bool DenseMLP::validate(cv::dnn::Net& net, const std::string& inputName,
+                        const std::string& outputName, float tolerance)
+{
+    if (empty()) {
+        return false;
+    }
+
+    // synthetic input (normalized features are roughly N(0, 1))
+    std::mt19937 rng(42);
+    std::normal_distribution<float> dist(0.0f, 1.0f);
+
+    AlignedBuffer X;
+    X.resize(inputStride());
+    std::fill(X.data(), X.data() + X.size(), 0.0f);
+
+    cv::Mat input(1, inputSize(), CV_32F);
+    for (int k = 0; k < inputSize(); ++k) {
+        X.data()[k] = dist(rng);
+        input.at<float>(0, k) = X.data()[k];
+    }
+
+    // reference output (cv::dnn)
+    net.setInput(input, inputName);
+    cv::Mat reference = net.forward(outputName);
+    if (reference.total() != static_cast<size_t>(outputSize())) {
+        return false;
+    }
+
+    // native output
+    std::vector<float> output(outputSize());
+    forward(X.data(), 1, output.data());
+
+    const float* ref = reference.ptr<float>();
+    float maxDiff = 0.0f, maxRef = 0.0f;
+    for (int j = 0; j < outputSize(); ++j) {
+        maxDiff = std::max(maxDiff, std::abs(output[j] - ref[j]));
+        maxRef = std::max(maxRef, std::abs(ref[j]));
+    }
+
+    return maxDiff <= tolerance * (1.0f + maxRef);
+}
+
+void DenseMLP::forward(const float* X, int n, float* Y)
+{
+    const float* in = X;
+    for (size_t l = 0; l < layers.size(); ++l) {
+        const DenseLayer& layer = layers[l];
+
+        float* out;
+        int ldy;
+        if (l + 1 == layers.size()) {
+            // last layer writes the caller's (unpadded) output
+            out = Y;
+            ldy = layer.out;
+        }
+        else {
+            // hidden activations are padded to the next layer's stride
+            ldy = layers[l + 1].stride;
+            AlignedBuffer& buffer = (l % 2 == 0) ? act0 : act1;
+            buffer.resize(static_cast<size_t>(n) * ldy);
+            out = buffer.data();
+        }
+
+        gemm(layer, in, n, out, ldy);
+        activate(layer.act, out, n, layer.out, ldy);
+
+        in = out;
+    }
+}
+
+void DenseMLP::gemm(const DenseLayer& layer, const float* X, int n, float* Y, int ldy)
+{
+    const int stride = layer.stride;
+    const float* W = layer.weights.data();
+
+    // each weight row is loaded once per block of 4 inputs
+    for (int j = 0; j < layer.out; ++j) {
+        const float* w = W + static_cast<size_t>(j) * stride;
+        const float b = layer.bias[j];
+
+        int i = 0;
+        for (; i + 4 <= n; i += 4) {
+            float dots[4];
+            dot4(w, X + static_cast<size_t>(i) * stride, X + static_cast<size_t>(i + 1) * stride,
+                 X + static_cast<size_t>(i + 2) * stride, X + static_cast<size_t>(i + 3) * stride,
+                 stride, dots);
+            for (int r = 0; r < 4; ++r) {
+                Y[static_cast<size_t>(i + r) * ldy + j] = dots[r] + b;
+            }
+        }
+        for (; i < n; ++i) {
+            Y[static_cast<size_t>(i) * ldy + j] = dot1(w, X + static_cast<size_t>(i) * stride, stride) + b;
+        }
+    }
+
+    // zero padding columns (inputs of the next layer)
+    if (ldy > layer.out) {
+        for (int i = 0; i < n; ++i) {
+            float* row = Y + static_cast<size_t>(i) * ldy;
+            std::fill(row + layer.out, row + ldy, 0.0f);
+        }
+    }
+}
+
+void DenseMLP::activate(Activation act, float* Y, int n, int cols, int ldy)
+{
+    if (act == ActNone) {
+        return;
+    }
+
+    for (int i = 0; i < n; ++i) {
+        float* row = Y + static_cast<size_t>(i) * ldy;
+        for (int j = 0; j < cols; ++j) {
+            switch (act) {
+                case ActReLU:    row[j] = std::max(row[j], 0.0f); break;
+                case ActSigmoid: row[j] = 1.0f / (1.0f + std::exp(-row[j])); break;
+                case ActTanH:    row[j] = std::tanh(row[j]); break;
+                default: break;
+            }
+        }
+    }
+}
@@ -0,0 +1,122 @@
+#ifndef DENSEMLP_H
+#define DENSEMLP_H
+
+#include <opencv2/dnn.hpp>
+
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief 64-byte aligned float buffer
+ * @note  contents are not preserved by resize()
+ */
+class AlignedBuffer {
+public:
+    static const size_t alignment = 64;
+
+    float* data() {return buffer.get();}
+    const float* data() const {return buffer.get();}
+    size_t size() const {return count;}
+
+    // (re)allocate for n floats if the buffer is too small
+    void resize(size_t n) {
+        if (n <= capacity) {
+            count = n;
+            return;
+        }
+
+        // aligned_alloc requires size to be a multiple of the alignment
+        size_t bytes = ((n * sizeof(float) + alignment - 1) / alignment) * alignment;
+        float* ptr = static_cast<float*>(std::aligned_alloc(alignment, bytes));
+        if (ptr == nullptr) {
+            throw std::bad_alloc();
+        }
+
+        buffer.reset(ptr);
+        capacity = bytes / sizeof(float);
+        count = n;
+    }
+
+private:
+    struct FreeDeleter {
+        void operator()(float* p) const {std::free(p);}
+    };
+
+    std::unique_ptr<float, FreeDeleter> buffer;
+    size_t count = 0;
+    size_t capacity = 0;
+};
+
+/**
+ * @brief Compiled inference path for small fully connected networks
+ * @note  Weights are extracted once from a loaded cv::dnn::Net (InnerProduct layers
+ *        and their activations) into aligned row-major buffers, and all inputs of a
+ *        batch (e.g., all faces in an image) are evaluated with one GEMM per layer.
+ */
+class DenseMLP {
+public:
+
+    enum Activation {
+        ActNone,
+        ActReLU,
+        ActSigmoid,
+        ActTanH
+    };
+
+    /**
+     * @brief extract the dense layers of <net> up to (and including) <outputName>
+     * @param inputSize - number of network inputs
+     * @return false if the network contains unsupported layers
+     *         (caller should keep using cv::dnn)
+     */
+    bool loadFromNet(cv::dnn::Net& net, const std::string& outputName, int inputSize);
+
+    /**
+     * @brief check native outputs against cv::dnn on a synthetic input
+     * @return true if max. abs. difference is within tolerance
+     */
+    bool validate(cv::dnn::Net& net, const std::string& inputName,
+                  const std::string& outputName, float tolerance = 1e-3f);
+
+    bool empty() const {return layers.empty();}
+
+    int inputSize() const {return empty() ? 0 : layers.front().in;}
+    int outputSize() const {return empty() ? 0 : layers.back().out;}
+
+    // row stride (in floats) of the input matrix passed to forward()
+    // Note: padding columns [inputSize, inputStride) must be zero
+    int inputStride() const {return empty() ? 0 : layers.front().stride;}
+
+    /**
+     * @brief Y = MLP(X)
+     * @param X - [n x inputStride()] row-major inputs (64-byte aligned)
+     * @param n - number of inputs (batch size)
+     * @param Y - [n x outputSize()] row-major outputs
+     */
+    void forward(const float* X, int n, float* Y);
+
+private:
+
+    struct DenseLayer {
+        int in = 0;       // number of inputs
+        int out = 0;      // number of outputs
+        int stride = 0;   // padded row length of weights and inputs (multiple of 8)
+        AlignedBuffer weights; // [out x stride] row-major, zero padded
+        std::vector<float> bias;  // [out]
+        Activation act = ActNone;
+    };
+
+    std::vector<DenseLayer> layers;
+
+    // scratch activations (reused across calls)
+    AlignedBuffer act0, act1;
+
+    // Y[n x out] = X[n x stride] * W^T + b
+    static void gemm(const DenseLayer& layer, const float* X, int n, float* Y, int ldy);
+
+    // apply activation on [n x cols] outputs with row stride ldy
+    static void activate(Activation act, float* Y, int n, int cols, int ldy);
+};
+#endif // DENSEMLP_H
@@ -29,6 +29,8 @@ EyeglassesDetector::EyeglassesDetector(const std::string& modelPath,
    
     eyeglassesNet_.setPreferableBackend(backendId);
     eyeglassesNet_.setPreferableTarget(targetId);
+
+    setupPreprocessor();
 }
 
 void EyeglassesDetector::init(const std::map<std::string, Type> params)
@@ -56,45 +58,77 @@ void EyeglassesDetector::init(const std::map<std::string, Type> params)
     if (params.find("NNOutputName") != params.end()) {
         outputName = params.at("NNOutputName").get<std::string>();
     }
+
+    setupPreprocessor();
+}
+
+void EyeglassesDetector::setupPreprocessor()
+{
+    ImagePreprocessor::Params preParams;
+    preParams.outSize = net_inputSize;
+    preParams.keepAspectRatio = false; // face crop is stretched to the input size
+    preParams.mean = cv::Scalar(0, 0, 0);
+    preParams.scale = scaleFactor;
+    preParams.swapRB = swapRB;
+    preParams.layout = ImagePreprocessor::NCHW;
+
+    preprocessor.setParams(preParams);
+
+    // network input blob (reused for all faces and images)
+    const int blobShape[] = {1, 3, net_inputSize.height, net_inputSize.width};
+    inputBlob.create(4, blobShape, CV_32F);
 }
 
 void EyeglassesDetector::run(Image &img)
 {
-    cv::Mat imgMat;
-    img.getImage_Mat(imgMat);
-    
-    // original image width and height
-    int imgWidth = imgMat.cols;
-    int imgHeight = imgMat.rows;
-
-    // TODO: update facial features class on Image
-    auto vFFeatures = img.getFacialFeatures();
-    
+    // face records are updated in place
+    auto& vFFeatures = img.getFacialFeaturesRef();
+
     // Loop through detected face bounding boxes
     for (auto& fFeatures : vFFeatures) {
 
-        auto faceBox = fFeatures.getFaceBbox();
+        // stop early (partial results) once the deadline has passed
+        if (img.isBudgetExhausted()) {
+            img.markPartial(getName());
+            break;
+        }
 
-        // crop face bbox and resize to model's input size
-        cv::Mat faceMat = imgMat(faceBox);
-        cv::resize(faceMat, faceMat, net_inputSize);
+        auto faceBox = fFeatures.getFaceBbox();
 
-        cv::Mat blob = cv::dnn::blobFromImage(faceMat, scaleFactor, net_inputSize,
-                                              cv::Scalar(0, 0, 0), swapRB, crop);
+        // crop face bbox, resize to model's input size and normalize
+        // (single pass, straight into the network's input blob)
+        preprocessor.run(img.getImage_Region(faceBox), inputBlob.ptr<float>());
         
-        eyeglassesNet_.setInput(blob, inputName);
+        eyeglassesNet_.setInput(inputBlob, inputName);
         auto output = eyeglassesNet_.forward(outputName);
 
         float probEyeglasses = output.at<float>(0, 1);
 
         // output: prob. of mouth open
-        auto pEyeglasses = std::make_shared<Eyeglasses>();
-        pEyeglasses->eyeglassesScore = probEyeglasses;
+        Eyeglasses eyeglasses;
+        eyeglasses.eyeglassesScore = probEyeglasses;
 
         // Update Aux Data in Facial Features class
-        fFeatures.setAuxData<Eyeglasses>(pEyeglasses);
+        fFeatures.setAuxData(eyeglasses);
     }
+}
 
-    // TODO: Image class should modify its facial features in-place (instead of clear and copy)
-    img.setFacialFeatures(vFFeatures);
-}
\ No newline at end of file
+std::vector<KAIExecConfig> EyeglassesDetector::getExecCandidates() const
+{
+    return getDnnExecCandidates();
+}
+
+void EyeglassesDetector::setExecConfig(const KAIExecConfig& config)
+{
+    eyeglassesNet_.setPreferableBackend(config.backendId);
+    eyeglassesNet_.setPreferableTarget(config.targetId);
+}
+
+void EyeglassesDetector::runSynthetic(int /*batchSize*/)
+{
+    // one face crop (faces are processed one at a time)
+    inputBlob.setTo(cv::Scalar(0));
+
+    eyeglassesNet_.setInput(inputBlob, inputName);
+    eyeglassesNet_.forward(outputName);
+}
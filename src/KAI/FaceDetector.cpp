@@ -1,6 +1,7 @@
 #include "FaceDetector.h"
 
 #include <iostream>
+#include <algorithm>
 
 FaceDetector::FaceDetector(const std::string& modelPath,
                 const std::string& configPath,
@@ -25,6 +26,8 @@ FaceDetector::FaceDetector(const std::string& modelPath,
    
     faceNet_.setPreferableBackend(backendId);
     faceNet_.setPreferableTarget(targetId);
+
+    setupPreprocessor();
 }
 
 void FaceDetector::init(const std::map<std::string, Type> params)
@@ -65,6 +68,26 @@ void FaceDetector::init(const std::map<std::string, Type> params)
     if (params.find("NNOutputName") != params.end()) {
         outputName = params.at("NNOutputName").get<std::string>();
     }
+
+    setupPreprocessor();
+}
+
+void FaceDetector::setupPreprocessor()
+{
+    ImagePreprocessor::Params preParams;
+    preParams.outSize = net_inputSize;
+    preParams.keepAspectRatio = true; // padded resize
+    preParams.padValue = cv::Scalar(114, 114, 114);
+    preParams.mean = imgMean;
+    preParams.scale = scaleFactor;
+    preParams.swapRB = swapRB;
+    preParams.layout = ImagePreprocessor::NCHW;
+
+    preprocessor.setParams(preParams);
+
+    // network input blob (reused for all images)
+    const int blobShape[] = {1, 3, net_inputSize.height, net_inputSize.width};
+    inputBlob.create(4, blobShape, CV_32F);
 }
 
 void FaceDetector::run(Image &img)
@@ -72,32 +95,50 @@ void FaceDetector::run(Image &img)
     // original image width and height
     auto imgSize = img.getImageSize();
 
-    // resize image to fit model's input size
-    cv::Mat img_resized;
-    std::vector<float> pad_info = img.resizeImage(img_resized, net_inputSize, true); // padded resize
+    // frame to detect on: nearest (larger) level of the shared image pyramid
+    float viewScale = 1.0f;
+    cv::Mat imgView = img.getImage_Pyramid(net_inputSize, viewScale);
+
+    // resize image to fit model's input size (padded resize)
+    // and normalize it, written straight into the network's input blob
+    auto pad_info = preprocessor.run(imgView, inputBlob.ptr<float>());
 
     cv::Mat detections;
-    cv::Mat blob;
 
-    blob = cv::dnn::blobFromImage(img_resized, scaleFactor, net_inputSize, imgMean, swapRB, crop);
-    faceNet_.setInput(blob, inputName);
+    faceNet_.setInput(inputBlob, inputName);
     detections = faceNet_.forward(outputName);
 
     // post-process network's face detection results
     cv::Mat bboxes(detections.size[2], detections.size[3], CV_32F, detections.ptr<float>());
-    auto faces = PostProcess(bboxes, pad_info[0], pad_info[1], pad_info[2], imgSize);
+    // (net input scale relative to the original image)
+    PostProcess(bboxes, pad_info.pad_w, pad_info.pad_h, pad_info.scale * viewScale, imgSize, faces);
+
+    // order faces by importance (largest and most confident first),
+    // so downstream tasks process them first when the deadline is tight
+    // (insertion sort: stable without the temporary buffer of std::stable_sort, few faces)
+    auto importance = [](const std::pair<cv::Rect, float>& face) {
+        return face.first.area() * face.second;
+    };
+    for (size_t i = 1; i < faces.size(); ++i) {
+        std::pair<cv::Rect, float> face = faces[i];
+        size_t j = i;
+        for (; j > 0 && importance(faces[j - 1]) < importance(face); --j) {
+            faces[j] = faces[j - 1];
+        }
+        faces[j] = face;
+    }
 
     img.setImage_faceBboxes(faces);
 }
 
-std::vector<std::pair<cv::Rect, float>> 
-FaceDetector::PostProcess(cv::Mat detections, float pad_w, float pad_h, float scale, const cv::Size& img_size)
+void FaceDetector::PostProcess(const cv::Mat& detections, float pad_w, float pad_h, float scale,
+                               const cv::Size& img_size, std::vector<std::pair<cv::Rect, float>>& faces)
 {
     auto clip = [](float n, float lower, float upper) {
         return std::max(lower, std::min(n, upper));
     };
 
-    std::vector<std::pair<cv::Rect, float>> faces;
+    faces.clear();
     for(int i = 0; i < detections.rows; i++)
     {
         float confidence = detections.at<float>(i, 2);
@@ -145,6 +186,24 @@ FaceDetector::PostProcess(cv::Mat detections, float pad_w, float pad_h, float sc
             faces.push_back(std::pair(face, confidence));
         }
     }
+}
 
-    return faces;
-}
\ No newline at end of file
+std::vector<KAIExecConfig> FaceDetector::getExecCandidates() const
+{
+    return getDnnExecCandidates();
+}
+
+void FaceDetector::setExecConfig(const KAIExecConfig& config)
+{
+    faceNet_.setPreferableBackend(config.backendId);
+    faceNet_.setPreferableTarget(config.targetId);
+}
+
+void FaceDetector::runSynthetic(int /*batchSize*/)
+{
+    // one image at the network input size
+    inputBlob.setTo(cv::Scalar(0));
+
+    faceNet_.setInput(inputBlob, inputName);
+    faceNet_.forward(outputName);
+}
@@ -2,6 +2,7 @@
 #define FACEDETECTOR_H
 
 #include "KAITaskInterface.h"
+#include "ImagePreprocessor.h"
 #include "Types.h"
 
 #include <opencv2/dnn.hpp>
@@ -19,6 +20,11 @@ public:
 
     void run(Image& img) override;
 
+    // auto-tuner: cv::dnn backends on the CPU
+    std::vector<KAIExecConfig> getExecCandidates() const override;
+    void setExecConfig(const KAIExecConfig& config) override;
+    void runSynthetic(int batchSize) override;
+
 private:
 
     cv::dnn::Net faceNet_;
@@ -36,7 +42,7 @@ private:
     
     // normalize image
     // x_n = (x - mean) / sigma
-    cv::Scalar imgMean = (104.0, 177.0, 123.0);
+    cv::Scalar imgMean = cv::Scalar(104.0, 177.0, 123.0);
     // mean subtract
     float scaleFactor = 1.0; // sigma scale
 
@@ -46,14 +52,24 @@ private:
     
     // confidence threshold
     float conf_thresh = 0.5;
+
+    // fused preprocessing (letterbox resize + normalization -> input blob)
+    ImagePreprocessor preprocessor;
+
+    // network input blob [1 x 3 x H x W] and detected faces (reused across images)
+    cv::Mat inputBlob;
+    std::vector<std::pair<cv::Rect, float>> faces;
+
+    // update preprocessor with the current network params
+    void setupPreprocessor();
     
     /***
      * @brief Scales detections to original image coordinates
      * @note  Further, filters out invalid detections 
-     * @return face boxes with shape: [x, y, w, h]
+     * @param faces - face boxes with shape: [x, y, w, h] (cleared first)
      */
-    std::vector< std::pair<cv::Rect, float> > 
-    PostProcess(cv::Mat detections, float pad_w, float pad_h, float scale, const cv::Size& img_size);
+    void PostProcess(const cv::Mat& detections, float pad_w, float pad_h, float scale,
+                     const cv::Size& img_size, std::vector<std::pair<cv::Rect, float>>& faces);
 
 
 };
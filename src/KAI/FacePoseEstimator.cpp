@@ -1,6 +1,7 @@
 #include "FacePoseEstimator.h"
 
 #include <iostream>
+#include <algorithm>
 
 FacePoseEstimator::FacePoseEstimator(const std::string& modelPath,
                 const std::string& configPath,
@@ -47,6 +48,11 @@ void FacePoseEstimator::init(const std::map<std::string, Type> params)
         mOutputName = params.at("NNOutputName").get<std::string>();
     }
 
+    // use the native MLP path (1, default) or cv::dnn (0)
+    if (params.find("UseNativeMLP") != params.end()) {
+        useNativeMLP = params.at("UseNativeMLP").get<int>() != 0;
+    }
+
     ///
     // read CSV file containing data normalization values (mean, std.)
     ///
@@ -88,39 +94,121 @@ void FacePoseEstimator::init(const std::map<std::string, Type> params)
     }
 
     file.close();
+
+    if (meanSubtract.size() < nMLFeatures || stdNormalize.size() < nMLFeatures) {
+        throw std::runtime_error("Face Pose Estimation Task -- "
+                                 "Invalid data normalization file: " + mMeanStdFilename);
+    }
+
+    // precompute 1/std (avoid divide by zero)
+    // Note: both (x, y) distances of a feature pair are normalized by the std. of the x distance
+    invStdNormalize.resize(nMLFeatures);
+    for (int i = 0; i < nMLFeatures; ++i) {
+        float std = stdNormalize[i & ~1];
+        if (std == 0.0)
+            std = 1;
+        invStdNormalize[i] = 1.0f / std;
+    }
+
+    // extract network weights once for the native MLP path
+    // and check it against cv::dnn before using it
+    if (useNativeMLP) {
+        useNativeMLP = poseMLP.loadFromNet(facePoseNet_, mOutputName, nMLFeatures)
+                       && poseMLP.outputSize() == 3
+                       && poseMLP.validate(facePoseNet_, mInputName, mOutputName);
+
+        if (!useNativeMLP) {
+            std::cerr << "Face Pose Estimation Task -- "
+                         "native MLP is not supported for this model, using cv::dnn." << std::endl;
+        }
+    }
 }
 
 void FacePoseEstimator::run(Image &img)
 {
-    // get facial features for all faces detected in Image
-    auto vFFeatures = img.getFacialFeatures();
+    // facial features of all faces detected in Image (updated in place)
+    auto& vFFeatures = img.getFacialFeaturesRef();
     
+    if (useNativeMLP) {
+        
+        // stop early (partial results) once the deadline has passed
+        if (img.isBudgetExhausted()) {
+            img.markPartial(getName());
+            return;
+        }
+
+        // feature rows for all faces: [nFaces x stride]
+        const int stride = poseMLP.inputStride();
+        featureBuffer.resize(vFFeatures.size() * stride);
+        faceRows.clear();
+
+        for (int f = 0; f < static_cast<int>(vFFeatures.size()); ++f) {
+            auto& faceFeature = vFFeatures[f];
+
+            // pose model uses the 68 Dlib feature points
+            LandmarkView featurePoints = faceFeature.getFacialFeatures();
+            if (featurePoints.size() < 68) {
+                continue;
+            }
+
+            float* row = featureBuffer.data() + faceRows.size() * stride;
+            computeDistFeaturePairs(featurePoints, faceFeature.getIOD(), row);
+            std::fill(row + nMLFeatures, row + stride, 0.0f); // zero padding
+
+            faceRows.push_back(f);
+        }
+
+        // one batched forward pass for all faces
+        const int numRows = static_cast<int>(faceRows.size());
+        poseBuffer.resize(numRows * 3);
+        if (numRows > 0) {
+            poseMLP.forward(featureBuffer.data(), numRows, poseBuffer.data());
+        }
+
+        for (int r = 0; r < numRows; ++r) {
+            HeadPose headPose;
+            headPose.roll = poseBuffer[r * 3 + 2];
+            headPose.yaw = poseBuffer[r * 3 + 1];
+            headPose.pitch = poseBuffer[r * 3 + 0];
+
+            // Update Aux Data in Facial Features class
+            vFFeatures[faceRows[r]].setAuxData(headPose);
+        }
+        return;
+    }
+
+    // cv::dnn path (one forward pass per face)
+    matDists.create(1, nMLFeatures, cv::DataType<float>::type);
+
     // for each detected face
     for(auto& faceFeature: vFFeatures) {
+        // stop early (partial results) once the deadline has passed
+        if (img.isBudgetExhausted()) {
+            img.markPartial(getName());
+            break;
+        }
+
         // get feature points
-        std::vector<cv::Point> featurePoints = faceFeature.getFacialFeatures();
+        LandmarkView featurePoints = faceFeature.getFacialFeatures();
+        if (featurePoints.size() < 68) {
+            continue;
+        }
         
         // compute dist vector between all feature pairs
         float iod = faceFeature.getIOD();
-        std::vector<float> distFpairs = computeDistFeaturePairs(featurePoints, iod);
-
-        // Create a cv::Mat object
-        // Copy data from the vector to cv::Mat
-        cv::Mat matDists(1, nMLFeatures, cv::DataType<float>::type);
-        std::memcpy(matDists.data, distFpairs.data(), distFpairs.size() * sizeof(float) );
+        computeDistFeaturePairs(featurePoints, iod, matDists.ptr<float>());
 
         try {
             facePoseNet_.setInput(matDists, mInputName);
             cv::Mat poseMat = facePoseNet_.forward();
 
-            // TODO: add face pose as HeadPose struct (AuxData) to FacialFeature class
-            auto pHeadPose = std::make_shared<HeadPose>();
-            pHeadPose->roll = poseMat.at<float>(0,2);
-            pHeadPose->yaw = poseMat.at<float>(0,1);
-            pHeadPose->pitch = poseMat.at<float>(0,0);
+            HeadPose headPose;
+            headPose.roll = poseMat.at<float>(0,2);
+            headPose.yaw = poseMat.at<float>(0,1);
+            headPose.pitch = poseMat.at<float>(0,0);
 
             // Update Aux Data in Facial Features class
-            faceFeature.setAuxData<HeadPose>(pHeadPose);            
+            faceFeature.setAuxData(headPose);
         }
         catch (cv::Exception& e) {
             // TODO: handle error
@@ -128,51 +216,98 @@ void FacePoseEstimator::run(Image &img)
             std::cerr << e.what() << std::endl;
         }
     }
-
-    // TODO: Image class should modify its facial features in-place (instead of clear and copy)
-    img.setFacialFeatures(vFFeatures);
 }
 
-std::vector<float> 
-FacePoseEstimator::computeDistFeaturePairs(std::vector<cv::Point> features, float IOD){
+void FacePoseEstimator::computeDistFeaturePairs(const LandmarkView& features,
+                                                float IOD, float* distFPairs) const {
     // NOTES:
     // 1. INITIAL MODEL USED EUCLIDEAN DISTANCE (L-2 norm) BETWEEN EACH PAIRS OF FACIAL FEATURE POINTS
     // (NOT IMPLEMENTED HERE)
     // 2. REVISED MODEL USES DELTA X AND DELTA Y (L-1 norm) BETWEEN EACH PAIR OF FACIAL FEATURE POINTS, (SKIPPING FACE OUTLINE POINTS)
 	
     float iod_scale = 100 / IOD;
+
+    // landmarks as contiguous x and y arrays (pre-scaled by iod_scale)
+    const float* fx = features.x();
+    const float* fy = features.y();
+    float xs[68], ys[68];
+    for (int i = 0; i < 68; ++i) {
+        xs[i] = iod_scale * fx[i];
+        ys[i] = iod_scale * fy[i];
+    }
+
+    const float* mean = meanSubtract.data();
+    const float* invStd = invStdNormalize.data();
     
     // compute dist between all possible feature pairs
     // (excluding the face outline; i.e., Dlib landmarks [0, 16])
-    std::vector<float> distFPairs;
-
+    // output: [dx(i,j), dy(i,j)] for i < j, written straight into distFPairs
 	int iFeature = 0;
 	for  ( int i = 17; i < 68; i++ )	// 17 == index of first feature point following face outline
 	{
-        float xDist, yDist;
-		for ( int j = i + 1; j < 68; j++ )
+        const float xi = xs[i];
+        const float yi = ys[i];
+        float* out = distFPairs + iFeature;
+        const float* m = mean + iFeature;
+        const float* s = invStd + iFeature;
+        const int n = 68 - (i + 1);
+
+		for ( int k = 0; k < n; k++ )
 		{
-            float std = stdNormalize[iFeature];
-            // avoid divide by zero
-            if (std == 0.0)
-                std = 1;
-
-            // (feature_i, feature_j).x dist
-			xDist = static_cast<float>(
-                                ( iod_scale * (features[i].x - features[j].x) - meanSubtract[iFeature])
-                                / std);
-			distFPairs.push_back(xDist);
-            
-            iFeature++;
-            // (feature_i, feature_j).y dist
-			yDist = static_cast<float>(
-                                ( iod_scale * (features[i].y - features[j].y) - meanSubtract[iFeature])
-                                / std);
-			distFPairs.push_back(yDist);
-            
-            iFeature++;
+            const int j = i + 1 + k;
+            out[2 * k]     = (xi - xs[j] - m[2 * k])     * s[2 * k];     // (feature_i, feature_j).x dist
+            out[2 * k + 1] = (yi - ys[j] - m[2 * k + 1]) * s[2 * k + 1]; // (feature_i, feature_j).y dist
 		}
+
+        iFeature += 2 * n;
 	}
+}
+
+std::vector<KAIExecConfig> FacePoseEstimator::getExecCandidates() const
+{
+    std::vector<KAIExecConfig> candidates;
+
+    // weights were extracted and validated in init()
+    if (!poseMLP.empty()) {
+        KAIExecConfig native;
+        native.engine = KAIEngine::NativeMLP;
+        candidates.push_back(native);
+    }
 
-    return distFPairs;   
-}
\ No newline at end of file
+    for (const auto& candidate : getDnnExecCandidates()) {
+        candidates.push_back(candidate);
+    }
+    return candidates;
+}
+
+void FacePoseEstimator::setExecConfig(const KAIExecConfig& config)
+{
+    useNativeMLP = (config.engine == KAIEngine::NativeMLP) && !poseMLP.empty();
+    if (!useNativeMLP) {
+        facePoseNet_.setPreferableBackend(config.backendId);
+        facePoseNet_.setPreferableTarget(config.targetId);
+    }
+}
+
+void FacePoseEstimator::runSynthetic(int batchSize)
+{
+    const int numRows = std::max(1, batchSize);
+
+    if (useNativeMLP) {
+        const int stride = poseMLP.inputStride();
+        featureBuffer.resize(numRows * stride);
+        std::fill(featureBuffer.data(), featureBuffer.data() + numRows * stride, 0.0f);
+        poseBuffer.resize(numRows * 3);
+
+        poseMLP.forward(featureBuffer.data(), numRows, poseBuffer.data());
+        return;
+    }
+
+    // cv::dnn: one face at a time
+    matDists.create(1, nMLFeatures, cv::DataType<float>::type);
+    matDists.setTo(cv::Scalar(0));
+    for (int r = 0; r < numRows; ++r) {
+        facePoseNet_.setInput(matDists, mInputName);
+        facePoseNet_.forward();
+    }
+}
@@ -3,6 +3,7 @@
 
 #include "KAITaskInterface.h"
 #include "FacialFeatures.h"
+#include "DenseMLP.h"
 #include "Types.h"
 
 #include <opencv2/dnn.hpp>
@@ -18,6 +19,11 @@ public:
 
     void run(Image& img) override;
 
+    // auto-tuner: native MLP (if validated) vs. cv::dnn backends on the CPU
+    std::vector<KAIExecConfig> getExecCandidates() const override;
+    void setExecConfig(const KAIExecConfig& config) override;
+    void runSynthetic(int batchSize) override;
+
 private:
     cv::dnn::Net facePoseNet_;
 
@@ -40,11 +46,24 @@ private:
     
     std::vector<float> meanSubtract; // [nMLFeatures];
     std::vector<float> stdNormalize; // [nMLFeatures];
+    std::vector<float> invStdNormalize; // [nMLFeatures] 1/std (precomputed)
+
+    // native (compiled) MLP path, batched across all faces
+    // (falls back to cv::dnn if the model has unsupported layers)
+    bool useNativeMLP = true;
+    DenseMLP poseMLP;
+
+    // scratch buffers (reused across images)
+    AlignedBuffer featureBuffer;      // [nFaces x poseMLP.inputStride()]
+    std::vector<float> poseBuffer;    // [nFaces x 3]
+    std::vector<int> faceRows;        // face index of each feature row
+    cv::Mat matDists;                 // [1 x nMLFeatures] cv::dnn input
 
     ///
     // helper functions
     ///
 
-    std::vector<float> computeDistFeaturePairs(std::vector<cv::Point> features, float IOD);
+    // write normalized pairwise landmark distances of a face to <distFPairs> [nMLFeatures]
+    void computeDistFeaturePairs(const LandmarkView& features, float IOD, float* distFPairs) const;
 };
 #endif // FACEPOSEESTIMATOR_H
\ No newline at end of file
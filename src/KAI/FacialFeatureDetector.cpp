@@ -1,14 +1,68 @@
 #include "FacialFeatureDetector.h"
+#include "KAIModelStore.h"
 
 #include <algorithm>
 
 FacialFeatureDetector::FacialFeatureDetector(const std::string& modelPath) {
-    // Load the shape predictor model
-    dlib::deserialize(modelPath) >> landmarkPredictor;
+    // Load the shape predictor model (shared by all pipelines;
+    // memory-mapped and shared by all processes with a model cache)
+    KAIModelStore& store = KAIModelStore::getInstance();
+    mappedPredictor = store.getMappedShapePredictor(modelPath);
+    if (mappedPredictor == nullptr) {
+        landmarkPredictor = store.getShapePredictor(modelPath);
+    }
+}
+
+void FacialFeatureDetector::init(const std::map<std::string, Type> params)
+{
+    // landmark each face on its own (normalized) chip
+    if (params.find("ROILandmarks") != params.end()) {
+        roiLandmarks = params.at("ROILandmarks").get<int>() != 0;
+    }
+
+    // face box size on the chip (pixels)
+    if (params.find("FaceChipSize") != params.end()) {
+        faceChipSize = std::max(16, params.at("FaceChipSize").get<int>());
+    }
+
+    // face box margin on each side (fraction of the box size)
+    // at most the face region kept by streaming images (larger chips would decode again per face)
+    if (params.find("FaceChipMargin") != params.end()) {
+        faceChipMargin = std::clamp(params.at("FaceChipMargin").get<float>(), 0.0f, Image::regionMargin);
+    }
 }
 
 void FacialFeatureDetector::run(Image& image) {
 
+    // ROI-local landmarking: cost per face is independent of the image resolution
+    // face records are written straight into the image (one per face)
+    const auto& faceBboxes = image.getImage_faceBboxesRef();
+    auto& vFeatures = image.getFacialFeaturesRef();
+    vFeatures.clear();
+    vFeatures.reserve(faceBboxes.size());
+    image.getLandmarkBuffer().clear();
+
+    if (roiLandmarks) {
+        for (const auto& [faceBox, conf] : faceBboxes) {
+
+            // stop early (partial results) once the deadline has passed
+            if (image.isBudgetExhausted()) {
+                image.markPartial(getName());
+                break;
+            }
+
+            dlib::full_object_detection landmarks = landmarkFaceChip(image, faceBox);
+
+            // extract main facial landmarks (e.g., eye, nose, lips corners)
+            FacialFeatures features;
+            features.setFaceBbox(std::make_pair(faceBox, conf));
+            features.setFFeaturesFromDlib(landmarks, image.getLandmarkBuffer());
+
+            vFeatures.push_back(features);
+        }
+        return;
+    }
+
     // original image width and height
     auto imgSize = image.getImageSize();
 
@@ -16,7 +70,15 @@ void FacialFeatureDetector::run(Image& image) {
     // [Dlib Bug]: Dlib model doesn't require specific size,
     //       but the dlib::shape_predictor() function
     //       throws SegFault for large images; e.g. 4236 x 3648
-    cv::Mat img_resized;
+    // (resized into a view of a fixed-capacity buffer, so images of any aspect ratio reuse it)
+    const float fitScale = std::min(static_cast<float>(net_inputSize.width) / imgSize.width,
+                                    static_cast<float>(net_inputSize.height) / imgSize.height);
+    if (resizeBuffer.empty()) {
+        resizeBuffer.create(net_inputSize, CV_8UC3);
+    }
+    cv::Mat img_resized = resizeBuffer(cv::Rect(0, 0,
+                                                std::min(net_inputSize.width, static_cast<int>(imgSize.width * fitScale)),
+                                                std::min(net_inputSize.height, static_cast<int>(imgSize.height * fitScale))));
     auto pad_info = image.resizeImage(img_resized, net_inputSize, false); // resize (keep ar w/o padding)
     float scale = pad_info[2];
 
@@ -24,9 +86,14 @@ void FacialFeatureDetector::run(Image& image) {
     dlib::cv_image<dlib::bgr_pixel> dlibImage(img_resized);
     
     // Loop through detected face bounding boxes
-    std::vector<FacialFeatures> vFeatures;
-    for (const auto& [faceBox, conf] : image.getImage_faceBboxes()) {
+    for (const auto& [faceBox, conf] : faceBboxes) {
         
+        // stop early (partial results) once the deadline has passed
+        if (image.isBudgetExhausted()) {
+            image.markPartial(getName());
+            break;
+        }
+
         // adjust face box scale to match Dlib model's input size
         // pyrUp = false (scaling from large input image to smaller net input)
         cv::Point tlPoint = faceBox.tl();
@@ -36,7 +103,7 @@ void FacialFeatureDetector::run(Image& image) {
 
         dlib::rectangle dlibRect(tlPoint.x, tlPoint.y, brPoint.x, brPoint.y);
         // detect facial landmarks using the "color image"
-        dlib::full_object_detection landmarks = landmarkPredictor(dlibImage, dlibRect);
+        dlib::full_object_detection landmarks = predictLandmarks(dlibImage, dlibRect);
         
         // scale landmarks back to original image size
         adjustLandmarksScale(landmarks, scale, imgSize);
@@ -44,12 +111,48 @@ void FacialFeatureDetector::run(Image& image) {
         // extract main facial landmarks (e.g., eye, nose, lips corners)
         FacialFeatures features;
         features.setFaceBbox(std::make_pair(faceBox, conf));
-        features.setFFeaturesFromDlib(landmarks);
+        features.setFFeaturesFromDlib(landmarks, image.getLandmarkBuffer());
 
         vFeatures.push_back(features);
     }
-    // Keep Facial Features with image
-    image.setFacialFeatures(vFeatures);
+}
+
+dlib::full_object_detection FacialFeatureDetector::landmarkFaceChip(Image& image, const cv::Rect& faceBox)
+{
+    const cv::Size imgSize = image.getImageSize();
+
+    // margin-padded face box (full-resolution pixels)
+    const int mw = static_cast<int>(faceBox.width * faceChipMargin);
+    const int mh = static_cast<int>(faceBox.height * faceChipMargin);
+    const cv::Rect chipBox = cv::Rect(faceBox.x - mw, faceBox.y - mh, faceBox.width + 2 * mw, faceBox.height + 2 * mh)
+                             & cv::Rect(cv::Point(0, 0), imgSize);
+    cv::Mat region = image.getImage_Region(chipBox);
+
+    // normalize the face box to faceChipSize pixels
+    const float scale = static_cast<float>(faceChipSize) / std::max(1, std::max(faceBox.width, faceBox.height));
+    const cv::Size chipSize(std::max(1, static_cast<int>(chipBox.width * scale + 0.5f)),
+                            std::max(1, static_cast<int>(chipBox.height * scale + 0.5f)));
+    cv::resize(region, faceChip, chipSize, 0, 0, scale < 1.0f ? cv::INTER_AREA : cv::INTER_LINEAR);
+
+    // face box in chip coordinates
+    const dlib::rectangle chipRect(static_cast<long>((faceBox.x - chipBox.x) * scale),
+                                   static_cast<long>((faceBox.y - chipBox.y) * scale),
+                                   static_cast<long>((faceBox.br().x - chipBox.x) * scale),
+                                   static_cast<long>((faceBox.br().y - chipBox.y) * scale));
+
+    dlib::cv_image<dlib::bgr_pixel> dlibChip(faceChip);
+    dlib::full_object_detection landmarks = predictLandmarks(dlibChip, chipRect);
+
+    // map landmarks back to original image coordinates
+    for (unsigned long i = 0; i < landmarks.num_parts(); ++i) {
+        const float x = landmarks.part(i).x() / scale + chipBox.x;
+        const float y = landmarks.part(i).y() / scale + chipBox.y;
+        landmarks.part(i) = dlib::point(static_cast<long>(std::max(0.0f, std::min(x, static_cast<float>(imgSize.width)))),
+                                        static_cast<long>(std::max(0.0f, std::min(y, static_cast<float>(imgSize.height)))));
+    }
+    landmarks.get_rect() = dlib::rectangle(faceBox.x, faceBox.y, faceBox.br().x, faceBox.br().y);
+
+    return landmarks;
 }
 
 void FacialFeatureDetector::adjustLandmarksScale(dlib::full_object_detection &landmarks,
@@ -3,16 +3,21 @@
 
 #include "KAITaskInterface.h"
 #include "FacialFeatures.h"
+#include "MappedShapePredictor.h"
+#include "Types.h"
 
 #include <dlib/image_processing.h>
 #include <dlib/image_io.h>
 #include <dlib/opencv.h> // operate OpenCV and Dlib
 
+#include <memory>
 #include <string>
 
 class FacialFeatureDetector: public KAITask {
 public:
     FacialFeatureDetector(const std::string& modelPath);
+
+    void init(const std::map<std::string, Type> params);
     
     // Override the run function to detect facial landmarks
     void run(Image& image) override;
@@ -26,14 +31,36 @@ private:
     // input size
     cv::Size net_inputSize = cv::Size(500, 500);
 
-    // Dlib inference head
-    dlib::shape_predictor landmarkPredictor;
+    // Dlib inference head (read-only, shared by all pipelines)
+    std::shared_ptr<const dlib::shape_predictor> landmarkPredictor;
+    std::shared_ptr<const MappedShapePredictor> mappedPredictor; // model cache (one of the two)
+
+    template <typename image_type>
+    dlib::full_object_detection predictLandmarks(const image_type& img, const dlib::rectangle& rect) const {
+        return mappedPredictor ? (*mappedPredictor)(img, rect) : (*landmarkPredictor)(img, rect);
+    }
+
+    // ROI-local landmarking: each face is landmarked on its own chip
+    // (margin-padded face box resized so that the face box is faceChipSize pixels),
+    // instead of on the whole image downscaled to net_inputSize
+    bool roiLandmarks = false;
+    int faceChipSize = 200;
+    float faceChipMargin = 0.2f; // face box margin on each side (at most Image::regionMargin)
+
+    // face chip (reused for all faces)
+    cv::Mat faceChip;
+
+    // downscaled image (net_inputSize capacity, reused for all images)
+    cv::Mat resizeBuffer;
 
 
     ///////////////////
     // Helper functions
     ///////////////////
 
+    // landmark one face on its face chip (landmarks in original image coordinates)
+    dlib::full_object_detection landmarkFaceChip(Image& image, const cv::Rect& faceBox);
+
     // scale Dlib model's predictions to actual image size
     void adjustLandmarksScale(dlib::full_object_detection& landmarks, float scale, const cv::Size& out_size);
 
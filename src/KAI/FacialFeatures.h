@@ -6,9 +6,12 @@
 #include <dlib/image_processing.h>
 #include <opencv2/core/types.hpp>
 
+#include <array>
+#include <cstdint>
+#include <memory_resource>
 #include <string>
+#include <tuple>
 #include <vector>
-#include <memory>
 
 struct FFeatureLocation
 {
@@ -108,7 +111,7 @@ Dlib facial landmarks
 	}
 };
 
-// Base class for auxiliary data
+// Auxiliary data identifiers
 struct AuxData {
 
 ////////////////////////////////
@@ -137,15 +140,16 @@ struct AuxData {
         ,eEyeglasses
 		,eNAuxDataID
 	};
-
-    eAuxDataID auxID;
-    
-    virtual ~AuxData() {}
-    AuxData(eAuxDataID id): auxID(id) {}
 };
 
-// 1. HeadPose derived from AuxData
-struct HeadPose : public AuxData {
+// Note: auxiliary data are plain fixed-layout records stored inline in FacialFeatures.
+//       Whether a record holds a result is tracked by validity bits (FacialFeatures::hasAuxData);
+//       the default values below are only returned for records that were never set.
+
+// 1. HeadPose
+struct HeadPose {
+    static const AuxData::eAuxDataID auxID = AuxData::eHeadPose;
+
     // The roll, pitch, and yaw values are degrees in [-180.0,180)
     // in a right-handed coordinate system with
     // - positive x to the viewer's right, 
@@ -165,98 +169,182 @@ struct HeadPose : public AuxData {
 	//	  look in the downward direction.
 	//	- Yaw is rotation around the y axis (the y axis points from the head to the feet).  If roll ==
 	//	  pitch == 0, a small positive yaw causes the face to look to the viewer's left.
-    float roll;
-    float yaw;
-    float pitch;
-
-    HeadPose() : AuxData(eHeadPose), roll(360.0f), yaw(360.0f), pitch(360.0f) {}
+    float roll = 360.0f;
+    float yaw = 360.0f;
+    float pitch = 360.0f;
 };
 
-// 2. EyesOpen derived from AuxData
-struct EyesOpen : public AuxData {
-    float leftEyeScore;
-    float rightEyeScore;
+// 2. EyesOpen
+struct EyesOpen {
+    static const AuxData::eAuxDataID auxID = AuxData::eEyesOpen;
 
-    EyesOpen() : AuxData(eEyesOpen), leftEyeScore(-1.0f), rightEyeScore(-1.0f) {}
+    float leftEyeScore = -1.0f;
+    float rightEyeScore = -1.0f;
 };
 
-// 3. Gaze derived from AuxData
-struct Gaze : public AuxData {
-    float leftEyeYaw;
-    float leftEyePitch;
-    std::vector<float> leftIrisXYR;
+// 3. Gaze
+struct Gaze {
+    static const AuxData::eAuxDataID auxID = AuxData::eGaze;
 
-    float rightEyeYaw;
-    float rightEyePitch;
-    std::vector<float> rightIrisXYR;
+    float leftEyeYaw = 360.0f;
+    float leftEyePitch = 360.0f;
+    float leftIrisXYR[3] = {0.0f, 0.0f, 0.0f};
 
-    Gaze()
-        : AuxData(eGaze), leftEyeYaw(360.0f), leftEyePitch(360.0f), leftIrisXYR(3, 0.0f),
-            rightEyeYaw(0.0f), rightEyePitch(0.0f), rightIrisXYR(3, 0.0f) {}
+    float rightEyeYaw = 360.0f;
+    float rightEyePitch = 360.0f;
+    float rightIrisXYR[3] = {0.0f, 0.0f, 0.0f};
 };
 
-// 4. MouthOpen derived from AuxData
-struct MouthOpen : public AuxData {
-    float openScore;
-    float mouthOpenRatio;
+// 4. MouthOpen
+struct MouthOpen {
+    static const AuxData::eAuxDataID auxID = AuxData::eMouthOpen;
 
-    MouthOpen() : AuxData(eMouthOpen), openScore(-1.0f), mouthOpenRatio(-1.0f) {}
+    float openScore = -1.0f;
 };
 
-// 5. Smile derived from AuxData
-struct Smile : public AuxData {
-    float smileScore;
+// 5. Smile
+struct Smile {
+    static const AuxData::eAuxDataID auxID = AuxData::eSmile;
 
-    Smile() : AuxData(eSmile), smileScore(-1.0f) {}
+    float smileScore = -1.0f;
 };
 
-// 6. RedEye derived from AuxData
-struct RedEye : public AuxData {
-    float leftRedEyeScore;
-    float leftEyeFractionRedPixels;
+// 6. RedEye
+struct RedEye {
+    static const AuxData::eAuxDataID auxID = AuxData::eRedEye;
 
-    float rightRedEyeScore;
-    float rightEyeFractionRedPixels;
+    float leftRedEyeScore = -1.0f;
+    float leftEyeFractionRedPixels = -1.0f;
 
-    RedEye() : AuxData(eRedEye), leftRedEyeScore(-1.0f), leftEyeFractionRedPixels(-1.0f),
-               rightRedEyeScore(-1.0f), rightEyeFractionRedPixels(-1.0f) {}
+    float rightRedEyeScore = -1.0f;
+    float rightEyeFractionRedPixels = -1.0f;
 };
 
-// 7. Eyeglasses derived from AuxData
-struct Eyeglasses : public AuxData {
-    float eyeglassesScore;
+// 7. Eyeglasses
+struct Eyeglasses {
+    static const AuxData::eAuxDataID auxID = AuxData::eEyeglasses;
 
-    Eyeglasses() : AuxData(eEyeglasses), eyeglassesScore(-1.0f) {}
+    float eyeglassesScore = -1.0f;
 };
 
-class FacialFeatures {
+/**
+ * @brief Per-image landmark storage (structure of arrays)
+ * @note  facial feature points of all faces in an image are stored contiguously
+ *        (x and y arrays); FacialFeatures records refer to their range in the buffer.
+ *        Points are allocated from <resource> (e.g., the image's arena).
+ */
+class LandmarkBuffer {
 public:
-    // Constructor
-    FacialFeatures(): smileDetected(false), mouthOpen(false){
-        // Initialize all feature locations to default
-        for (int i = 0; i < FFeatureLocation::FFNCommonFeatures; ++i) {
-            FFlocs.push_back(FFeatureLocation());
+    explicit LandmarkBuffer(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : xs(resource), ys(resource) {}
+
+    // append points and return the offset of the first one
+    uint32_t append(const dlib::full_object_detection& landmarks) {
+        uint32_t offset = static_cast<uint32_t>(xs.size());
+        for (unsigned long i = 0; i < landmarks.num_parts(); ++i) {
+            xs.push_back(static_cast<float>(landmarks.part(i).x()));
+            ys.push_back(static_cast<float>(landmarks.part(i).y()));
         }
+        return offset;
+    }
 
-        // Initialize all auxiliary data 
-        vAuxData.resize(AuxData::eNAuxDataID);
-        vAuxData[AuxData::eHeadPose] = std::make_shared<HeadPose>();
-        vAuxData[AuxData::eEyesOpen] = std::make_shared<EyesOpen>();
-        vAuxData[AuxData::eGaze] = std::make_shared<Gaze>();
-        vAuxData[AuxData::eMouthOpen] = std::make_shared<MouthOpen>();
-        vAuxData[AuxData::eSmile] = std::make_shared<Smile>();
-        vAuxData[AuxData::eRedEye] = std::make_shared<RedEye>();
-        vAuxData[AuxData::eEyeglasses] = std::make_shared<Eyeglasses>();
+    uint32_t append(const std::vector<cv::Point>& landmarks) {
+        uint32_t offset = static_cast<uint32_t>(xs.size());
+        for (const auto& point : landmarks) {
+            xs.push_back(static_cast<float>(point.x));
+            ys.push_back(static_cast<float>(point.y));
+        }
+        return offset;
     }
 
+    const float* x() const {return xs.data();}
+    const float* y() const {return ys.data();}
+    size_t size() const {return xs.size();}
+
+    void reserve(size_t n) {
+        xs.reserve(n);
+        ys.reserve(n);
+    }
+
+    // drop all points (keeps capacity for the next image)
+    void clear() {
+        xs.clear();
+        ys.clear();
+    }
+
+private:
+    std::pmr::vector<float> xs;
+    std::pmr::vector<float> ys;
+};
+
+/**
+ * @brief Read-only view of one face's feature points in a LandmarkBuffer
+ */
+class LandmarkView {
+public:
+    LandmarkView() = default;
+    LandmarkView(const float* x, const float* y, size_t n): xs(x), ys(y), count(n) {}
+
+    size_t size() const {return count;}
+    bool empty() const {return count == 0;}
+
+    // contiguous coordinates
+    const float* x() const {return xs;}
+    const float* y() const {return ys;}
+
+    cv::Point operator[](size_t i) const {
+        return cv::Point(static_cast<int>(xs[i]), static_cast<int>(ys[i]));
+    }
+
+    // simple forward iterator (yields cv::Point)
+    class const_iterator {
+    public:
+        const_iterator(const LandmarkView* v, size_t i): view(v), idx(i) {}
+        cv::Point operator*() const {return (*view)[idx];}
+        const_iterator& operator++() {++idx; return *this;}
+        bool operator!=(const const_iterator& other) const {return idx != other.idx;}
+    private:
+        const LandmarkView* view;
+        size_t idx;
+    };
+
+    const_iterator begin() const {return const_iterator(this, 0);}
+    const_iterator end() const {return const_iterator(this, count);}
+
+private:
+    const float* xs = nullptr;
+    const float* ys = nullptr;
+    size_t count = 0;
+};
+
+/**
+ * @brief Compact per-face record
+ * @note  fixed layout, no heap allocations: facial landmarks and auxiliary data are stored
+ *        inline, feature points live in the image's LandmarkBuffer.
+ *        Records refer to their image's LandmarkBuffer and are valid while the Image lives.
+ */
+class FacialFeatures {
+public:
+    // Constructor
+    FacialFeatures() = default;
+
     // landmarks, including (eye, mouth, nose) left/right corners and center
-    std::vector<FFeatureLocation>  getFacialLandmarks() const {
+    const std::array<FFeatureLocation, FFeatureLocation::FFNCommonFeatures>& getFacialLandmarks() const {
         return FFlocs;
     };
 
     // get all available facial feature points
-    std::vector<cv::Point> getFacialFeatures() const {
-        return vFFpoints;
+    LandmarkView getFacialFeatures() const {
+        if (pLandmarkBuffer == nullptr || numFFpoints == 0) {
+            return LandmarkView();
+        }
+        return LandmarkView(pLandmarkBuffer->x() + FFpointsOffset,
+                            pLandmarkBuffer->y() + FFpointsOffset, numFFpoints);
+    }
+
+    // landmark buffer the feature points live in (nullptr if there are none)
+    const LandmarkBuffer* getLandmarkBuffer() const {
+        return pLandmarkBuffer;
     }
 
     std::vector<cv::Point> getFacialFeatures(const std::string& mode) const {
@@ -277,7 +365,9 @@ public:
 
         }
         else{ // All feature points
-            vFFs = vFFpoints;
+            for (const auto& point: getFacialFeatures()){
+                vFFs.push_back(point);
+            }
         }
 
         return vFFs;
@@ -287,22 +377,23 @@ public:
      * @brief set facial features detected by Dlib (68 landmarks)
      * 
      * @param landmarks - holds facial feature points (x,y)
+     * @param buffer    - image's landmark buffer (stores the points)
      */
-    void setFFeaturesFromDlib(const dlib::full_object_detection& landmarks){
+    void setFFeaturesFromDlib(const dlib::full_object_detection& landmarks, LandmarkBuffer& buffer){
         
-        vFFpoints.clear();
-        for (int i = 0; i < landmarks.num_parts(); ++i) {
-            vFFpoints.push_back(cv::Point(landmarks.part(i).x(), landmarks.part(i).y()));
-        }
+        pLandmarkBuffer = &buffer;
+        FFpointsOffset = buffer.append(landmarks);
+        numFFpoints = static_cast<uint32_t>(landmarks.num_parts());
 
         // save specific FFpoints as facial landmarks
         setFacialLandmarksFromDlib(landmarks);
     }
 
-    void setFFeaturesFromTFLite(const std::vector<cv::Point> &landmarks){
+    void setFFeaturesFromTFLite(const std::vector<cv::Point> &landmarks, LandmarkBuffer& buffer){
         
-        vFFpoints.clear();
-        vFFpoints = landmarks;
+        pLandmarkBuffer = &buffer;
+        FFpointsOffset = buffer.append(landmarks);
+        numFFpoints = static_cast<uint32_t>(landmarks.size());
 
         // TODO:
         // 1. Add FeaturePointMode "Dlib" : map 468 landmarks down to 68
@@ -312,80 +403,61 @@ public:
     }
 
     void setFaceBbox(const std::pair<cv::Rect, float>& bbox){
-        faceBbox = bbox;
+        faceBbox = bbox.first;
+        faceConfidence = bbox.second;
     }
     
     cv::Rect getFaceBbox() const {
-        return faceBbox.first;
+        return faceBbox;
     }
 
-    /*
-    // We set Face Pose as an AuxData now
-    void setFacePose(const std::vector<float>& facePose){
-        
-        RollYawPitch.clear();
-        // TODO: assert size is 3 and values in [0, 360)
-        RollYawPitch = facePose;
+    float getFaceConfidence() const {
+        return faceConfidence;
     }
-    */
-
-    std::vector<float> getFacePose() const {
-        
-        // TODO: fix seg fault error
-        //       when vAuxData is not initialized with HeadPose
-        auto pHeadPose = getAuxData<HeadPose>(AuxData::eHeadPose);
-        
-        std::vector<float> RollYawPitch = {360.0f, 360.0f, 360.0f};
-        RollYawPitch[0] = pHeadPose->roll;
-        RollYawPitch[1] = pHeadPose->yaw;
-        RollYawPitch[2] = pHeadPose->pitch;
 
-        return RollYawPitch;
+    // Roll, Yaw, Pitch (360 when head pose is not available)
+    std::array<float, 3> getFacePose() const {
+        const HeadPose& headPose = getAuxData<HeadPose>();
+        return {headPose.roll, headPose.yaw, headPose.pitch};
     }
 
     float isMouthOpen() const {
-        auto pMouthOpen = getAuxData<MouthOpen>(AuxData::eMouthOpen);
-
-        return pMouthOpen->openScore;
+        return getAuxData<MouthOpen>().openScore;
     }
-    float getMouthOpenRatio() const {
-        auto pMouthOpen = getAuxData<MouthOpen>(AuxData::eMouthOpen);
-
-        // compute MouthOpen Ratio (if not available) before returning aux data
-        if(pMouthOpen->mouthOpenRatio == -1){
-            const float ratio = computeMouthOpenRatioDlib();
-            pMouthOpen->mouthOpenRatio = ratio;
-        }
 
-        return pMouthOpen->mouthOpenRatio;
+    // mouth open ratio computed from Dlib feature points (-1 when not available)
+    float getMouthOpenRatio() const {
+        return computeMouthOpenRatioDlib();
     }
 
     float isSmileDetected() const {
-        auto pSmile = getAuxData<Smile>(AuxData::eSmile);
-
-        return pSmile->smileScore;
+        return getAuxData<Smile>().smileScore;
     }
 
     float isEyeglassesDetected() const {
-        auto pEyeglasses = getAuxData<Eyeglasses>(AuxData::eEyeglasses);
-
-        return pEyeglasses->eyeglassesScore;
+        return getAuxData<Eyeglasses>().eyeglassesScore;
     }
 
     // Methods to add or retrieve auxiliary data
     template<typename T>
-    void setAuxData(std::shared_ptr<T> auxData) {
-        vAuxData[auxData->auxID] = auxData;
+    void setAuxData(const T& auxData) {
+        std::get<T>(auxRecords) = auxData;
+        auxValid |= (1u << T::auxID);
     }
 
+    // Note: returns default values if the data was never set (see hasAuxData)
     template<typename T>
-    std::shared_ptr<T> getAuxData(AuxData::eAuxDataID auxID) const {
-        return std::dynamic_pointer_cast<T>(vAuxData[auxID]);
+    const T& getAuxData() const {
+        return std::get<T>(auxRecords);
+    }
+
+    bool hasAuxData(AuxData::eAuxDataID auxID) const {
+        return (auxValid & (1u << auxID)) != 0;
     }
 
     // Methods to handle additional features (e.g., smile detection, eye state)
 
-    float getIOD() {
+    float getIOD() const {
         return computeIOD();
     }
 
@@ -397,29 +469,26 @@ public:
 
 private:
     // face bounding box and confidence score
-    std::pair<cv::Rect, float> faceBbox;
+    cv::Rect faceBbox;
+    float faceConfidence = 0.0f;
 
-    // facial feature points
-    // e.g., 68 for Dlib model
-    std::vector<cv::Point> vFFpoints;
+    // facial feature points (e.g., 68 for Dlib model)
+    // stored in the image's landmark buffer: [offset, offset + num)
+    // Note: not owned; a copy of this record is only valid while that image lives
+    const LandmarkBuffer* pLandmarkBuffer = nullptr;
+    uint32_t FFpointsOffset = 0;
+    uint32_t numFFpoints = 0;
 
     // Facial landmarks (eyes, nose, mouth)
-    std::vector<FFeatureLocation> FFlocs;
-
-    // Auxiliary facial features
-    
-    // vector to store all auxiliary data
-    std::vector<std::shared_ptr<AuxData>> vAuxData;
+    std::array<FFeatureLocation, FFeatureLocation::FFNCommonFeatures> FFlocs;
 
-    // 1. Head Pose (Roll, Yaw, and Pitch)
-    // param range: [0, 360) degrees
-    // (360 is invalid value)
+    // Auxiliary facial features (stored inline)
+    // 1. Head Pose (Roll, Yaw, and Pitch), 2. Eyes Open, 3. Gaze,
+    // 4. Mouth Open, 5. Smile, 6. Red Eye, 7. Eyeglasses
+    std::tuple<HeadPose, EyesOpen, Gaze, MouthOpen, Smile, RedEye, Eyeglasses> auxRecords;
 
-    // 4. Mouth Open
-    bool mouthOpen;
-
-    // 5. Smile Detected
-    bool smileDetected;
+    // validity bit per AuxData::eAuxDataID
+    uint32_t auxValid = 0;
 
     ///
     // helper functions
@@ -443,7 +512,7 @@ private:
         //       MouthCenter    = average(62, 66)    (?)
 
         // left eye
-        float centroid_x, centroid_y;
+        float centroid_x = 0, centroid_y = 0;
         for (int i = 36; i < 42; ++i){
             centroid_x += landmarks.part(i).x();
             centroid_y += landmarks.part(i).y();
@@ -469,7 +538,7 @@ private:
     // helper methods
     ///////////////////////
     
-    float computeIOD(){
+    float computeIOD() const {
         // left eye center
         float Cx_leftEye = FFlocs[FFeatureLocation::FFLeftEyeCenter].mX;
         float Cy_leftEye = FFlocs[FFeatureLocation::FFLeftEyeCenter].mY;
@@ -486,6 +555,12 @@ private:
     float computeMouthOpenRatioDlib() const {
     
         float mouthOpenRatio = -1.0f;
+
+        // requires the 68 Dlib feature points
+        LandmarkView vFFpoints = getFacialFeatures();
+        if (vFFpoints.size() != 68) {
+            return mouthOpenRatio;
+        }
         
         // vector from left to right mouth corner
         float LipLineDx, LipLineDy;
@@ -527,4 +602,4 @@ private:
 
 
 };
-#endif // FACIALFEATURES_H
\ No newline at end of file
+#endif // FACIALFEATURES_H
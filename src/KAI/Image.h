@@ -2,10 +2,17 @@
 #define IMAGE_H
 
 #include <vector>
+#include <memory>
+#include <memory_resource>
 #include <mutex>
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
 
 #include <opencv2/opencv.hpp>
 #include "FacialFeatures.h"
+#include "Deadline.h"
+#include "StreamingJpegDecoder.h"
 
 class Image {
 public:
@@ -25,6 +32,26 @@ public:
         imgMat = cv::imread(img_path);
     }
 
+    // image already decoded in memory (e.g., from a request body)
+    Image(const cv::Mat& mat, const std::string& name): imageName(name), imgMat(mat) {}
+
+    /**
+     * @brief streaming image (very large JPEGs)
+     * @note  the full-resolution frame is never decoded as a whole: a preview (long side
+     *        >= previewSize) is decoded in strips for face detection, and only the
+     *        (margin-padded) face regions are kept at full resolution.
+     */
+    Image(std::shared_ptr<StreamingJpegDecoder> decoder, const std::string& name, int previewSize = 1024)
+        : imageName(name), stripDecoder(std::move(decoder)) {
+        
+        imgSize = stripDecoder->getSize();
+        previewMat = stripDecoder->decodePreview(previewSize, previewScale);
+    }
+
+    bool isStreaming() const {
+        return stripDecoder != nullptr;
+    }
+
     void getImage_Mat(cv::Mat& outMat){
         
         std::lock_guard<std::mutex> lock(imageMutex); // protect access
@@ -32,15 +59,78 @@ public:
         imgMat.copyTo(outMat);
     }
 
+    // read-only view of the image pixels (no copy)
+    // Note: pixels are never modified after loading, so the view can be shared by tasks
+    cv::Mat getImage_View() const {
+        return imgMat;
+    }
+
     cv::Size getImageSize(){
-        return imgMat.size();
+        return isStreaming() ? imgSize : imgMat.size();
+    }
+
+    /**
+     * @brief downscaled frame from the shared image pyramid (no copy)
+     * @note  the pyramid (successive INTER_AREA halvings) is built once, on first use,
+     *        and shared by all tasks; resample from the returned level instead of
+     *        from the full-resolution image.
+     * @param minScale - smallest acceptable scale (level size / original image size)
+     * @param scale - scale of the returned level
+     * @return smallest level with scale >= minScale (the largest level otherwise)
+     */
+    cv::Mat getImage_Pyramid(float minScale, float& scale){
+        
+        std::call_once(pyramidOnce, [this] {buildPyramid();});
+
+        // levels are ordered from large to small
+        size_t level = 0;
+        while (level + 1 < pyramid.size() && pyramidScales[level + 1] >= minScale) {
+            ++level;
+        }
+
+        scale = pyramidScales[level];
+        return pyramid[level];
+    }
+
+    // smallest pyramid level that covers <out_size> (aspect ratio kept)
+    cv::Mat getImage_Pyramid(const cv::Size& out_size, float& scale){
+        cv::Size size = getImageSize();
+        float minScale = std::min(static_cast<float>(out_size.width) / size.width,
+                                  static_cast<float>(out_size.height) / size.height);
+        return getImage_Pyramid(minScale, scale);
+    }
+
+    // face box margin on each side (fraction of the box size) kept at full resolution for
+    // streaming images; per-face crops within it are served without decoding again
+    static constexpr float regionMargin = 0.5f;
+
+    // full-resolution pixels of <box> (clipped to the image), read-only view (no copy)
+    // Note: streaming images keep the face regions only; other boxes are decoded on demand
+    cv::Mat getImage_Region(const cv::Rect& box){
+        
+        cv::Rect roi = box & cv::Rect(cv::Point(0, 0), getImageSize());
+        if (!isStreaming()) {
+            return imgMat(roi);
+        }
+
+        std::lock_guard<std::mutex> lock(imageMutex); // protect access
+
+        for (const auto& [regionBox, regionMat] : regions) {
+            if ((roi & regionBox) == roi) {
+                return regionMat(roi - regionBox.tl());
+            }
+        }
+
+        cv::Mat regionMat = stripDecoder->decodeRegions({roi}).front();
+        regions.emplace_back(roi, regionMat);
+        return regionMat;
     }
 
     std::vector<std::pair<cv::Rect, float>> getImage_faceBboxes(){
         
         std::lock_guard<std::mutex> lock(imageMutex); // protect access
         
-        return faceBboxes;
+        return {faceBboxes.begin(), faceBboxes.end()};
     }
 
     void setImage_faceBboxes(const std::vector<std::pair<cv::Rect, float>>& bboxes){
@@ -49,25 +139,74 @@ public:
 
         // clear current vector elements
         faceBboxes.clear();
-        faceBboxes = bboxes;
+        faceBboxes.assign(bboxes.begin(), bboxes.end());
+
+        // one record per face (no regrowth while the tasks fill them in)
+        vFacialFeatures.reserve(faceBboxes.size());
+
+        // streaming images: keep the full-resolution face regions (second decoding pass)
+        if (isStreaming()) {
+            std::vector<cv::Rect> faceRegions;
+            for (const auto& faceBbox : faceBboxes) {
+                const cv::Rect& face = faceBbox.first;
+                const int mw = static_cast<int>(face.width * regionMargin);
+                const int mh = static_cast<int>(face.height * regionMargin);
+                faceRegions.push_back(cv::Rect(face.x - mw, face.y - mh, face.width + 2 * mw, face.height + 2 * mh)
+                                      & cv::Rect(cv::Point(0, 0), imgSize));
+            }
+
+            regions.clear();
+            std::vector<cv::Mat> regionMats = stripDecoder->decodeRegions(faceRegions);
+            for (size_t i = 0; i < faceRegions.size(); ++i) {
+                regions.emplace_back(faceRegions[i], regionMats[i]);
+            }
+        }
     }
 
-    void setFacialFeatures(std::vector<FacialFeatures> features){
+    // Note: the feature points of a record live in the landmark buffer of the
+    // image it came from, so only records of this image (or without points) are accepted
+    void setFacialFeatures(const std::vector<FacialFeatures>& features){
         
         std::lock_guard<std::mutex> lock(imageMutex); // protect access
 
+        for (const auto& feature: features){
+            const LandmarkBuffer* buffer = feature.getLandmarkBuffer();
+            if (buffer != nullptr && buffer != &landmarkBuffer){
+                throw std::runtime_error("[KAI Image]-- Error: facial features refer to the landmark buffer of another image");
+            }
+        }
+
         // clear current vector elements
         vFacialFeatures.clear();
-        vFacialFeatures = features;
+        vFacialFeatures.assign(features.begin(), features.end());
     }
 
+    // Note: the returned records are not self-contained; their feature points
+    // (getFacialFeatures() of a record) point into this image's landmark buffer
+    // and dangle once the image is destroyed. Copy the points to keep them longer.
     std::vector<FacialFeatures> getFacialFeatures(){
         
         std::lock_guard<std::mutex> lock(imageMutex); // protect access
         
+        return {vFacialFeatures.begin(), vFacialFeatures.end()};
+    }
+
+    // in-place access for the tasks (no copy of the face records)
+    // Note: not locked; the tasks of a pipeline run one at a time on an image
+    const std::pmr::vector<std::pair<cv::Rect, float>>& getImage_faceBboxesRef() const {
+        return faceBboxes;
+    }
+
+    std::pmr::vector<FacialFeatures>& getFacialFeaturesRef(){
         return vFacialFeatures;
     }
 
+    // storage for the feature points of all faces in the image
+    // (FacialFeatures records refer to it, so it lives as long as the image)
+    LandmarkBuffer& getLandmarkBuffer(){
+        return landmarkBuffer;
+    }
+
     void getImage_faceOn(cv::Mat& outMat){
         if (imgMat.empty()){
             return;
@@ -100,6 +239,77 @@ public:
         return imageName;
     }
 
+    //////////////////////////////////
+    // Latency budget
+    //////////////////////////////////
+
+    void setDeadline(const Deadline& d){
+        deadline = d;
+    }
+
+    const Deadline& getDeadline() const {
+        return deadline;
+    }
+
+    // tasks check this between faces and stop early once it is true
+    bool isBudgetExhausted() const {
+        return deadline.expired();
+    }
+
+    // flag results as partial: <taskName> was skipped or did not process all faces
+    void markPartial(const std::string& taskName){
+        
+        std::lock_guard<std::mutex> lock(imageMutex); // protect access
+
+        if(std::find(vPartialTasks.begin(), vPartialTasks.end(), taskName) == vPartialTasks.end()){
+            vPartialTasks.push_back(taskName);
+        }
+    }
+
+    bool isPartial(){
+        
+        std::lock_guard<std::mutex> lock(imageMutex); // protect access
+        
+        return !vPartialTasks.empty();
+    }
+
+    // names of the tasks that were skipped or cut short by the deadline
+    std::vector<std::string> getPartialTasks(){
+        
+        std::lock_guard<std::mutex> lock(imageMutex); // protect access
+        
+        return {vPartialTasks.begin(), vPartialTasks.end()};
+    }
+
+    //////////////////////////////////
+    // Requested outputs
+    //////////////////////////////////
+
+    // outputs the caller needs (task names, e.g. {"FaceDetection", "Smile"}); empty: all tasks
+    // Note: the pipeline runs these tasks and their prerequisites only
+    void setRequestedTasks(const std::vector<std::string>& tasks){
+        requestedTasks = tasks;
+    }
+
+    const std::vector<std::string>& getRequestedTasks() const {
+        return requestedTasks;
+    }
+
+    //////////////////////////////////
+    // Scheduling
+    //////////////////////////////////
+
+    // called by the pipeline between tasks (e.g. bulk work yields to interactive requests)
+    void setTaskBoundaryHook(std::function<void()> hook){
+        taskBoundaryHook = std::move(hook);
+    }
+
+    void onTaskBoundary(){
+        if (taskBoundaryHook) {
+            taskBoundaryHook();
+        }
+    }
+
     //////////////////////////////////
     // Image manipulation functions
     //////////////////////////////////
@@ -119,12 +329,13 @@ public:
     std::vector<float> resizeImage(cv::Mat& dst, const cv::Size& out_size = cv::Size(300, 300),
                                     bool pad = false) {
 
-        cv::Mat src;
-        imgMat.copyTo(src);
+        // resampled from the nearest (larger) pyramid level
+        float levelScale = 1.0f;
+        cv::Mat src = getImage_Pyramid(out_size, levelScale);
 
-        // source and dest. image dimensions
-        auto in_h = static_cast<float>(src.rows);
-        auto in_w = static_cast<float>(src.cols);
+        // source (original image) and dest. image dimensions
+        auto in_h = static_cast<float>(getImageSize().height);
+        auto in_w = static_cast<float>(getImageSize().width);
         float out_h = out_size.height;
         float out_w = out_size.width;
 
@@ -155,7 +366,7 @@ public:
                                     bool pad = false) {
 
         // image roi
-        cv::Mat src = imgMat(box);
+        cv::Mat src = getImage_Region(box);
 
         // source and dest. image dimensions
         auto in_h = static_cast<float>(src.rows);
@@ -192,16 +403,70 @@ private:
     // Mutex to protect shared image data
     std::mutex imageMutex;
 
+    /**
+     * @brief per-image arena for the transient records below (boxes, face records,
+     *        landmark points, pyramid/region headers, partial task names)
+     * @note  bump allocation from chunks obtained from the heap; individual frees are
+     *        no-ops and everything is released at once when the image is destroyed.
+     *        Not thread safe: allocations happen under imageMutex or from the task
+     *        running on the image. Pixel data stays with OpenCV's allocator.
+     *        Declared before the containers that use it (destroyed after them).
+     */
+    static constexpr size_t arenaInitialSize = 16 * 1024; // first chunk (bytes)
+    std::pmr::monotonic_buffer_resource arena{arenaInitialSize};
+
     std::string imageName; // image file name
     cv::Mat imgMat;        // image cv::Mat variable
 
+    // streaming images (imgMat stays empty)
+    std::shared_ptr<StreamingJpegDecoder> stripDecoder;
+    cv::Size imgSize;                                  // original image size
+    cv::Mat previewMat;                                // downscaled frame (detection)
+    float previewScale = 1.0f;                         // preview size / original size
+    std::pmr::vector<std::pair<cv::Rect, cv::Mat>> regions{&arena}; // full-resolution face regions (regionMargin)
+
+    // shared image pyramid (built once, on first use)
+    std::once_flag pyramidOnce;
+    std::pmr::vector<cv::Mat> pyramid{&arena};     // level 0: full image (streaming images: preview)
+    std::pmr::vector<float> pyramidScales{&arena}; // level size / original image size
+    const int minPyramidSize = 64;      // smallest level dimension
+
+    void buildPyramid(){
+        pyramid.push_back(isStreaming() ? previewMat : imgMat);
+        pyramidScales.push_back(isStreaming() ? previewScale : 1.0f);
+
+        while (std::min(pyramid.back().cols, pyramid.back().rows) / 2 >= minPyramidSize) {
+            cv::Mat level;
+            cv::resize(pyramid.back(), level, cv::Size(pyramid.back().cols / 2, pyramid.back().rows / 2),
+                       0, 0, cv::INTER_AREA);
+
+            pyramidScales.push_back(pyramidScales.back() * static_cast<float>(level.cols) / pyramid.back().cols);
+            pyramid.push_back(level);
+        }
+    }
+
     // Face Detection results
     // bounding boxes (x, y, width, height) and confidence scores
-    std::vector<std::pair<cv::Rect, float>> faceBboxes;
+    std::pmr::vector<std::pair<cv::Rect, float>> faceBboxes{&arena};
 
     // Facial Features (landmarks, smile, gaze, eyeglasses, etc)
     // (for all detected faces)
-    std::vector<FacialFeatures> vFacialFeatures;
+    std::pmr::vector<FacialFeatures> vFacialFeatures{&arena};
+
+    // feature points of all faces (structure of arrays)
+    LandmarkBuffer landmarkBuffer{&arena};
+
+    // latency budget for processing this image (unbounded by default)
+    Deadline deadline;
+
+    // tasks that were dropped or truncated to meet the deadline
+    std::pmr::vector<std::string> vPartialTasks{&arena};
+
+    // outputs requested by the caller (empty: all tasks)
+    std::vector<std::string> requestedTasks;
+
+    // scheduler hook between tasks (none by default)
+    std::function<void()> taskBoundaryHook;
 
     //////////////////////////////////
     // visualization utility functions
@@ -224,7 +489,7 @@ private:
         // get FacialFeatures class for each face detected in image
         for(const auto& faceFeatures: vFacialFeatures){
             // get facial landmarks (e.g., eye, lip, nose corners)
-            auto landmarks = faceFeatures.getFacialLandmarks();
+            const auto& landmarks = faceFeatures.getFacialLandmarks();
 
             // draw a circle to show each landmark on the face
             for (const auto& landmark: landmarks){
@@ -254,15 +519,17 @@ private:
 
         // get FacialFeatures class for each face detected in image
         for(const auto& faceFeatures: vFacialFeatures) {
-            // get face pose vector
-            auto facePose = faceFeatures.getFacePose();
-            std::string text = "Roll:" + std::to_string(static_cast<int>(facePose[0])) + 
-                              ", Yaw:" + std::to_string(static_cast<int>(facePose[1])) + 
-                              ", Pitch:" + std::to_string(static_cast<int>(facePose[2]));
-
-            auto faceBox = faceFeatures.getFaceBbox(); // only outputs bbox (no conf)
-            cv::putText(overlayImg, text, cv::Point(faceBox.x+2, faceBox.y-5),
-                        cv::FONT_HERSHEY_SIMPLEX, 0.5, cv::Scalar(255, 45, 45), 1);
+            // get face pose vector (if estimated)
+            if (faceFeatures.hasAuxData(AuxData::eHeadPose)) {
+                auto facePose = faceFeatures.getFacePose();
+                std::string text = "Roll:" + std::to_string(static_cast<int>(facePose[0])) + 
+                                  ", Yaw:" + std::to_string(static_cast<int>(facePose[1])) + 
+                                  ", Pitch:" + std::to_string(static_cast<int>(facePose[2]));
+
+                auto faceBox = faceFeatures.getFaceBbox(); // only outputs bbox (no conf)
+                cv::putText(overlayImg, text, cv::Point(faceBox.x+2, faceBox.y-5),
+                            cv::FONT_HERSHEY_SIMPLEX, 0.5, cv::Scalar(255, 45, 45), 1);
+            }
 
             // print mouth open prob. for now
             float mouthOpenScore = faceFeatures.isMouthOpen();
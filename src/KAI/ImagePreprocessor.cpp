@@ -0,0 +1,311 @@
+#include "ImagePreprocessor.h"
+
+#include <opencv2/core/hal/intrin.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+#if CV_SIMD
+    // 8-bit lanes -> 4 float vectors (v_uint8::nlanes == 4 * v_float32::nlanes)
+    inline void expandToFloat(const cv::v_uint8& u, cv::v_float32 f[4]) {
+        cv::v_uint16 w0, w1;
+        cv::v_expand(u, w0, w1);
+        cv::v_uint32 d0, d1, d2, d3;
+        cv::v_expand(w0, d0, d1);
+        cv::v_expand(w1, d2, d3);
+        f[0] = cv::v_cvt_f32(cv::v_reinterpret_as_s32(d0));
+        f[1] = cv::v_cvt_f32(cv::v_reinterpret_as_s32(d1));
+        f[2] = cv::v_cvt_f32(cv::v_reinterpret_as_s32(d2));
+        f[3] = cv::v_cvt_f32(cv::v_reinterpret_as_s32(d3));
+    }
+#endif
+}
+
+ImagePreprocessor::PadInfo
+ImagePreprocessor::run(const cv::Mat& src, const cv::Rect& roi, float* dst)
+{
+    if (src.empty() || src.type() != CV_8UC3) {
+        throw std::runtime_error("Image Preprocessor -- Error: expects a non-empty CV_8UC3 image.");
+    }
+
+    // ensure roi is inside the frame
+    cv::Rect box = roi & cv::Rect(0, 0, src.cols, src.rows);
+    if (box.empty()) {
+        throw std::runtime_error("Image Preprocessor -- Error: roi is outside the image.");
+    }
+
+    // source (roi) and dest. dimensions
+    const int in_w = box.width;
+    const int in_h = box.height;
+    const int out_w = params.outSize.width;
+    const int out_h = params.outSize.height;
+
+    // scale factor equal to the min of [w_out/w_in] or [h_out/h_in]
+    float scale = std::min(static_cast<float>(out_w) / in_w, static_cast<float>(out_h) / in_h);
+
+    // resized roi size and its offset in the output (letterbox)
+    int mid_w = out_w, mid_h = out_h;
+    int left = 0, top = 0;
+    PadInfo padInfo{-1.0f, -1.0f, scale};
+    if (params.keepAspectRatio) {
+        mid_w = std::max(1, static_cast<int>(in_w * scale));
+        mid_h = std::max(1, static_cast<int>(in_h * scale));
+        left = (out_w - mid_w) / 2;
+        top = (out_h - mid_h) / 2;
+
+        padInfo.pad_w = static_cast<float>(left);
+        padInfo.pad_h = static_cast<float>(top);
+    }
+
+    ///
+    // horizontal interpolation tables
+    // (bilinear, pixel centers aligned as in cv::resize INTER_LINEAR)
+    ///
+    const double fx = static_cast<double>(in_w) / mid_w;
+    xofs0.resize(mid_w);
+    xofs1.resize(mid_w);
+    xalpha.resize(mid_w);
+    for (int dx = 0; dx < mid_w; ++dx) {
+        double sx = (dx + 0.5) * fx - 0.5;
+        int x0 = static_cast<int>(std::floor(sx));
+        float a = static_cast<float>(sx - x0);
+
+        if (x0 < 0) {
+            x0 = 0;
+            a = 0.0f;
+        }
+        if (x0 >= in_w - 1) {
+            x0 = in_w - 1;
+            a = 0.0f;
+        }
+        int x1 = std::min(x0 + 1, in_w - 1);
+
+        xofs0[dx] = (box.x + x0) * 3;
+        xofs1[dx] = (box.x + x1) * 3;
+        xalpha[dx] = a;
+    }
+
+    hrow0.resize(static_cast<size_t>(mid_w) * 3);
+    hrow1.resize(static_cast<size_t>(mid_w) * 3);
+    vrow.resize(static_cast<size_t>(mid_w) * 3);
+    hrowIdx0 = hrowIdx1 = -1;
+
+    ///
+    // single pass over the output rows
+    // (each source row is resampled at most once and reused by consecutive output rows)
+    ///
+    const double fy = static_cast<double>(in_h) / mid_h;
+    const size_t rowLen = static_cast<size_t>(mid_w) * 3;
+    for (int dy = 0; dy < out_h; ++dy) {
+
+        // top/bottom padding
+        if (dy < top || dy >= top + mid_h) {
+            writePadRow(dst, dy, 0, out_w);
+            continue;
+        }
+
+        double sy = (dy - top + 0.5) * fy - 0.5;
+        int y0 = static_cast<int>(std::floor(sy));
+        float b = static_cast<float>(sy - y0);
+        if (y0 < 0) {
+            y0 = 0;
+            b = 0.0f;
+        }
+        if (y0 >= in_h - 1) {
+            y0 = in_h - 1;
+            b = 0.0f;
+        }
+        int y1 = std::min(y0 + 1, in_h - 1);
+
+        // horizontally resampled rows y0 (and y1)
+        if (hrowIdx0 != y0) {
+            if (hrowIdx1 == y0) {
+                std::swap(hrow0, hrow1);
+                std::swap(hrowIdx0, hrowIdx1);
+            }
+            else {
+                resampleRow(src.ptr<uchar>(box.y + y0), hrow0.data(), mid_w);
+                hrowIdx0 = y0;
+            }
+        }
+        if (b > 0.0f && hrowIdx1 != y1) {
+            resampleRow(src.ptr<uchar>(box.y + y1), hrow1.data(), mid_w);
+            hrowIdx1 = y1;
+        }
+
+        // vertical blend
+        const float* row = hrow0.data();
+        if (b > 0.0f) {
+            const float* p0 = hrow0.data();
+            const float* p1 = hrow1.data();
+            float* v = vrow.data();
+            size_t i = 0;
+#if CV_SIMD
+            const cv::v_float32 vb = cv::vx_setall_f32(b);
+            for (; i + cv::v_float32::nlanes <= rowLen; i += cv::v_float32::nlanes) {
+                const cv::v_float32 v0 = cv::vx_load(p0 + i);
+                cv::v_store(v + i, cv::v_muladd(vb, cv::vx_load(p1 + i) - v0, v0));
+            }
+#endif
+            for (; i < rowLen; ++i) {
+                v[i] = p0[i] + b * (p1[i] - p0[i]);
+            }
+            row = vrow.data();
+        }
+
+        // left/right padding
+        if (left > 0) {
+            writePadRow(dst, dy, 0, left);
+        }
+        if (left + mid_w < out_w) {
+            writePadRow(dst, dy, left + mid_w, out_w);
+        }
+
+        writeRow(row, dst, dy, left, mid_w);
+    }
+
+#if CV_SIMD
+    cv::vx_cleanup();
+#endif
+    return padInfo;
+}
+
+void ImagePreprocessor::resampleRow(const uchar* srcRow, float* out, int width) const
+{
+    const int* ofs0 = xofs0.data();
+    const int* ofs1 = xofs1.data();
+    const float* alpha = xalpha.data();
+
+    int dx = 0;
+#if CV_SIMD
+    // v_uint8::nlanes output pixels per step: per channel, gather the left/right neighbours
+    // (table lookup), widen to float, interpolate, then store the 3 channels interleaved
+    const int step = cv::v_uint8::nlanes;
+    const int lanes = cv::v_float32::nlanes;
+    for (; dx + step <= width; dx += step) {
+        cv::v_float32 a[4];
+        for (int q = 0; q < 4; ++q) {
+            a[q] = cv::vx_load(alpha + dx + q * lanes);
+        }
+
+        cv::v_float32 ch[3][4];
+        for (int c = 0; c < 3; ++c) {
+            cv::v_float32 f0[4], f1[4];
+            expandToFloat(cv::v_lut(srcRow + c, ofs0 + dx), f0);
+            expandToFloat(cv::v_lut(srcRow + c, ofs1 + dx), f1);
+            for (int q = 0; q < 4; ++q) {
+                ch[c][q] = cv::v_muladd(a[q], f1[q] - f0[q], f0[q]);
+            }
+        }
+
+        for (int q = 0; q < 4; ++q) {
+            cv::v_store_interleave(out + 3 * (dx + q * lanes), ch[0][q], ch[1][q], ch[2][q]);
+        }
+    }
+#endif
+
+    for (; dx < width; ++dx) {
+        const uchar* p0 = srcRow + ofs0[dx];
+        const uchar* p1 = srcRow + ofs1[dx];
+        const float a = alpha[dx];
+
+        out[3 * dx + 0] = p0[0] + a * (p1[0] - p0[0]);
+        out[3 * dx + 1] = p0[1] + a * (p1[1] - p0[1]);
+        out[3 * dx + 2] = p0[2] + a * (p1[2] - p0[2]);
+    }
+}
+
+void ImagePreprocessor::writeRow(const float* rowPixels, float* dst, int dy, int left, int width) const
+{
+    const int out_w = params.outSize.width;
+    const int out_h = params.outSize.height;
+
+    // output channel oc is read from source channel srcCh[oc]
+    // and normalized as x * scale + bias[oc] (= (x - mean[oc]) * scale)
+    const int srcCh[3] = {params.swapRB ? 2 : 0, 1, params.swapRB ? 0 : 2};
+    const float s = params.scale;
+    float bias[3];
+    for (int oc = 0; oc < 3; ++oc) {
+        bias[oc] = static_cast<float>(-params.mean[oc] * s);
+    }
+
+    // NCHW: one pointer per plane; NHWC: interleaved
+    const bool planar = (params.layout == NCHW);
+    const size_t plane = static_cast<size_t>(out_w) * out_h;
+    float* out = planar ? dst + static_cast<size_t>(dy) * out_w + left
+                        : dst + (static_cast<size_t>(dy) * out_w + left) * 3;
+
+    int x = 0;
+#if CV_SIMD
+    const int lanes = cv::v_float32::nlanes;
+    const cv::v_float32 vs = cv::vx_setall_f32(s);
+    const cv::v_float32 vbias[3] = {cv::vx_setall_f32(bias[0]), cv::vx_setall_f32(bias[1]),
+                                    cv::vx_setall_f32(bias[2])};
+    for (; x + lanes <= width; x += lanes) {
+        cv::v_float32 in[3];
+        cv::v_load_deinterleave(rowPixels + 3 * x, in[0], in[1], in[2]);
+
+        const cv::v_float32 o0 = cv::v_muladd(in[srcCh[0]], vs, vbias[0]);
+        const cv::v_float32 o1 = cv::v_muladd(in[srcCh[1]], vs, vbias[1]);
+        const cv::v_float32 o2 = cv::v_muladd(in[srcCh[2]], vs, vbias[2]);
+
+        if (planar) {
+            cv::v_store(out + x, o0);
+            cv::v_store(out + plane + x, o1);
+            cv::v_store(out + 2 * plane + x, o2);
+        }
+        else {
+            cv::v_store_interleave(out + 3 * x, o0, o1, o2);
+        }
+    }
+#endif
+
+    for (; x < width; ++x) {
+        const float* in = rowPixels + 3 * x;
+        const float o0 = in[srcCh[0]] * s + bias[0];
+        const float o1 = in[srcCh[1]] * s + bias[1];
+        const float o2 = in[srcCh[2]] * s + bias[2];
+
+        if (planar) {
+            out[x] = o0;
+            out[plane + x] = o1;
+            out[2 * plane + x] = o2;
+        }
+        else {
+            out[3 * x + 0] = o0;
+            out[3 * x + 1] = o1;
+            out[3 * x + 2] = o2;
+        }
+    }
+}
+
+void ImagePreprocessor::writePadRow(float* dst, int dy, int from, int to) const
+{
+    const int out_w = params.outSize.width;
+    const int out_h = params.outSize.height;
+
+    // normalized padding value per output channel
+    const int srcCh[3] = {params.swapRB ? 2 : 0, 1, params.swapRB ? 0 : 2};
+    float padOut[3];
+    for (int oc = 0; oc < 3; ++oc) {
+        padOut[oc] = static_cast<float>((params.padValue[srcCh[oc]] - params.mean[oc]) * params.scale);
+    }
+
+    if (params.layout == NCHW) {
+        const size_t plane = static_cast<size_t>(out_w) * out_h;
+        for (int oc = 0; oc < 3; ++oc) {
+            float* out = dst + oc * plane + static_cast<size_t>(dy) * out_w;
+            std::fill(out + from, out + to, padOut[oc]);
+        }
+    }
+    else { // NHWC
+        float* out = dst + static_cast<size_t>(dy) * out_w * 3;
+        for (int x = from; x < to; ++x) {
+            out[3 * x + 0] = padOut[0];
+            out[3 * x + 1] = padOut[1];
+            out[3 * x + 2] = padOut[2];
+        }
+    }
+}
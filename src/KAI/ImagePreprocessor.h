@@ -0,0 +1,111 @@
+#ifndef IMAGEPREPROCESSOR_H
+#define IMAGEPREPROCESSOR_H
+
+#include <opencv2/core.hpp>
+
+#include <vector>
+
+/**
+ * @brief Fused single-pass network input preprocessing
+ * @note  crop (roi) + resize (bilinear, optional letterbox padding) + channel swap
+ *        + mean/scale normalization + layout (NCHW or NHWC), written straight
+ *        into the network's float input buffer.
+ *        Replaces the chain resizeImage -> cvtColor -> convertTo -> memcpy
+ *        (or resize -> blobFromImage) and its intermediate images.
+ * @note  The row kernels (horizontal resampling, vertical blend, normalization and
+ *        NCHW/NHWC stores) use OpenCV universal intrinsics (SSE/AVX2/NEON, per OpenCV build),
+ *        with scalar tails.
+ * @note  Source image must be CV_8UC3. Not thread safe (holds scratch buffers);
+ *        each task owns its own instance.
+ */
+class ImagePreprocessor {
+public:
+
+    enum Layout {
+        NCHW, // planar   (OpenCV DNN blobs)
+        NHWC  // interleaved (TFLite tensors)
+    };
+
+    struct Params {
+        cv::Size outSize = cv::Size(300, 300); // network input size
+
+        // true : keep aspect ratio and pad to outSize (letterbox, like Image::resizeImage)
+        // false: stretch roi to outSize (like cv::resize)
+        bool keepAspectRatio = true;
+
+        // border color for letterbox padding (source pixel values)
+        cv::Scalar padValue = cv::Scalar(114, 114, 114);
+
+        // x_n = (x - mean) * scale
+        // mean is given in output channel order (i.e., after swapRB)
+        cv::Scalar mean = cv::Scalar(0, 0, 0);
+        float scale = 1.0f;
+
+        bool swapRB = false;   // BGR -> RGB
+        Layout layout = NCHW;
+    };
+
+    // padding information (same convention as Image::resizeImage)
+    // pad width and height = -1 when the roi is stretched (no padding)
+    struct PadInfo {
+        float pad_w;
+        float pad_h;
+        float scale;
+    };
+
+    ImagePreprocessor() = default;
+    explicit ImagePreprocessor(const Params& p): params(p) {}
+
+    void setParams(const Params& p) {params = p;}
+    const Params& getParams() const {return params;}
+
+    // number of floats written per image: 3 x H x W
+    size_t outputSize() const {
+        return static_cast<size_t>(params.outSize.area()) * 3;
+    }
+
+    /**
+     * @brief preprocess src(roi) into dst
+     * @param src - source image (CV_8UC3)
+     * @param roi - region of interest in src (e.g., face box)
+     * @param dst - network input buffer, must hold outputSize() floats
+     * @return padding information (to map network coordinates back to roi)
+     */
+    PadInfo run(const cv::Mat& src, const cv::Rect& roi, float* dst);
+
+    // preprocess the whole image
+    PadInfo run(const cv::Mat& src, float* dst) {
+        return run(src, cv::Rect(0, 0, src.cols, src.rows), dst);
+    }
+
+private:
+
+    Params params;
+
+    ///
+    // scratch buffers (reused across calls)
+    ///
+
+    // horizontal interpolation tables (per output column)
+    std::vector<int> xofs0, xofs1;  // source byte offsets of left/right neighbours
+    std::vector<float> xalpha;      // weight of the right neighbour
+
+    // horizontally resampled source rows (interleaved, 3 channels)
+    std::vector<float> hrow0, hrow1;
+    int hrowIdx0 = -1, hrowIdx1 = -1; // source rows held by hrow0/hrow1
+
+    // vertically blended output row (interleaved, 3 channels)
+    std::vector<float> vrow;
+
+    ///
+    // helper functions
+    ///
+
+    // resample one source row into <out> using the x tables
+    void resampleRow(const uchar* srcRow, float* out, int width) const;
+
+    // write one row of pixels (or padding) in the requested layout
+    void writeRow(const float* rowPixels, float* dst, int dy, int left, int width) const;
+    void writePadRow(float* dst, int dy, int from, int to) const;
+};
+#endif // IMAGEPREPROCESSOR_H
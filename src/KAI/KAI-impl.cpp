@@ -7,9 +7,222 @@
 #include "Image.h"
 
 #include "KAITaskManager.h"
+#include "KAIServer.h"
+#include "KAIReactor.h"
+#include "KAIShmServer.h"
+#include "KAIBatchPipeline.h"
+#include "KAIThreadingPolicy.h"
+#include "KAIModelStore.h"
+
+#include <csignal>
+#include <memory>
 
 // using json = nlohmann::json;
 
+// threading policy from the command line (<workers>: images processed in parallel)
+// Note: process-wide settings are applied here, before any library thread pool is created
+KAIThreadingPolicy makeThreadingPolicy(int workers) {
+    KAIThreadingPolicy policy;
+    policy.totalCores = parser_getNumCores();
+    policy.interImageWorkers = workers;
+    policy.intraOpThreads = parser_getIntraOpThreads();
+    policy.pinWorkers = parser_isPinThreads();
+    policy.numaLocal = parser_isNumaLocal();
+    policy.applyGlobal();
+    return policy;
+}
+
+// startup auto-tuner (nullptr unless -autotune is given)
+std::unique_ptr<KAIAutoTuner> makeAutoTuner() {
+    std::unique_ptr<KAIAutoTuner> tuner;
+    if (!parser_getAutoTuneCache().empty()) {
+        tuner.reset(new KAIAutoTuner(parser_getAutoTuneCache()));
+    }
+    return tuner;
+}
+
+int runServer(const std::string& json_path, int port, int deadline_ms) {
+
+    Logger& logger = Logger::getInstance();
+
+    // requests share one pipeline (one image at a time): all cores go to its tasks
+    KAIThreadingPolicy threading = makeThreadingPolicy(1);
+    threading.pinCurrentThread(0);
+
+    // resident pipeline (shared by all requests)
+    KAITaskManager kaiTaskManager;
+    kaiTaskManager.setThreadingPolicy(threading);
+
+    std::unique_ptr<KAIAutoTuner> autoTuner = makeAutoTuner();
+    kaiTaskManager.setAutoTuner(autoTuner.get());
+    kaiTaskManager.setWarmUpRuns(parser_getWarmUpRuns());
+    kaiTaskManager.loadMLConfigs(json_path);
+
+    // hot reload (also POST /reload)
+    if (parser_isWatchConfig()) {
+        kaiTaskManager.watchMLConfigs();
+    }
+
+    KAIHttpHandler handler(kaiTaskManager);
+    handler.setDefaultDeadlineMs(deadline_ms);
+
+    // optional admission control (decoded images in flight)
+    std::unique_ptr<KAIMemoryBudget> memoryBudget;
+    if (parser_getMemoryBudgetMB() > 0) {
+        memoryBudget.reset(new KAIMemoryBudget(static_cast<size_t>(parser_getMemoryBudgetMB()) * 1024 * 1024));
+        handler.setMemoryBudget(memoryBudget.get());
+    }
+
+    int io_threads = parser_getIOThreads();
+    const unsigned long max_body = static_cast<unsigned long>(parser_getMaxBodyMB()) * 1024 * 1024;
+
+    std::string msg = "[KAI Server]-- Listening on port " + std::to_string(port) +
+                      (io_threads > 0 ? " (event-driven)" : "") +
+                      " (POST /process, GET /health)";
+    logger.log(INFO, msg);
+    std::cout << msg << std::endl;
+
+    try {
+        // blocks until the server is shut down
+        if (io_threads > 0) {
+            // few I/O threads multiplex all connections, requests run on the compute threads
+            KAIReactor reactor(handler, io_threads, parser_getComputeThreads());
+            reactor.setListeningPort(port);
+            reactor.setMaxContentLength(max_body);
+            reactor.start();
+        }
+        else {
+            // one thread per connection
+            KAIServer server(handler);
+            server.set_listening_port(port);
+            server.set_max_content_length(max_body);
+            server.start();
+        }
+    }
+    catch (const std::exception& e) {
+        std::string err = "[KAI Server]-- Error: " + std::string(e.what());
+        logger.log(ERROR, err);
+        std::cerr << err << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+// shared-memory server (stopped by SIGINT/SIGTERM)
+KAIShmServer* pShmServer = nullptr;
+
+void stopShmServer(int) {
+    if (pShmServer != nullptr) {
+        pShmServer->stop();
+    }
+}
+
+int runShmServer(const std::string& json_path, const std::string& shm_name, int deadline_ms) {
+
+    Logger& logger = Logger::getInstance();
+
+    KAIThreadingPolicy threading = makeThreadingPolicy(1);
+    threading.pinCurrentThread(0);
+
+    // resident pipeline
+    KAITaskManager kaiTaskManager;
+    kaiTaskManager.setThreadingPolicy(threading);
+
+    std::unique_ptr<KAIAutoTuner> autoTuner = makeAutoTuner();
+    kaiTaskManager.setAutoTuner(autoTuner.get());
+    kaiTaskManager.setWarmUpRuns(parser_getWarmUpRuns());
+    kaiTaskManager.loadMLConfigs(json_path);
+
+    // hot reload
+    if (parser_isWatchConfig()) {
+        kaiTaskManager.watchMLConfigs();
+    }
+
+    KAIShmChannel channel;
+    try {
+        // results buffer: JSON with feature points for a few dozen faces
+        const size_t slotBytes = static_cast<size_t>(parser_getShmSlotMB()) * 1024 * 1024;
+        channel.create(shm_name, parser_getShmSlots(), slotBytes, 4 * 1024 * 1024);
+    }
+    catch (const std::exception& e) {
+        std::string err = "[KAI Shm Server]-- Error: " + std::string(e.what());
+        logger.log(ERROR, err);
+        std::cerr << err << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    KAIShmServer server(kaiTaskManager, channel);
+    server.setDefaultDeadlineMs(deadline_ms);
+
+    pShmServer = &server;
+    std::signal(SIGINT, stopShmServer);
+    std::signal(SIGTERM, stopShmServer);
+
+    std::string msg = "[KAI Shm Server]-- Serving shared-memory channel " + shm_name +
+                      " (" + std::to_string(parser_getShmSlots()) + " slots)";
+    logger.log(INFO, msg);
+    std::cout << msg << std::endl;
+
+    // blocks until SIGINT/SIGTERM
+    server.run();
+    pShmServer = nullptr;
+
+    return EXIT_SUCCESS;
+}
+
+int runBatch(const std::string& json_path, const std::string& input_dir,
+             const std::string& output_dir, int deadline_ms) {
+
+    Logger& logger = Logger::getInstance();
+
+    std::vector<std::string> inputPaths = KAIBatchPipeline::listImages(input_dir);
+    if (inputPaths.empty()) {
+        std::string err = "[KAI Batch]-- Error: no images found in " + input_dir;
+        logger.log(ERROR, err);
+        std::cerr << err << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    KAIBatchPipeline::Config config;
+    config.readThreads = parser_getBatchReadThreads();
+    config.decodeThreads = parser_getBatchDecodeThreads();
+    config.inferenceInstances = parser_getBatchInferInstances();
+    config.encodeThreads = parser_getBatchEncodeThreads();
+    config.writeThreads = parser_getBatchWriteThreads();
+    config.queueDepth = static_cast<size_t>(parser_getBatchQueueDepth());
+    config.memoryBudgetMB = static_cast<size_t>(parser_getMemoryBudgetMB());
+    config.streamingMinMP = parser_getStreamMP();
+    config.deadlineMs = deadline_ms;
+    config.requestedTasks = KAITaskManager::parseTaskList(parser_getRequestedTasks());
+    config.threading = makeThreadingPolicy(config.inferenceInstances);
+
+    std::unique_ptr<KAIAutoTuner> autoTuner = makeAutoTuner();
+    config.autoTuner = autoTuner.get();
+    config.warmUpRuns = parser_getWarmUpRuns();
+
+    // models are loaded once per inference instance
+    KAIBatchPipeline pipeline(json_path, config);
+
+    for (const auto& taskName : config.requestedTasks) {
+        if (!pipeline.hasTask(taskName)) {
+            std::string err = "[KAI Batch]-- Error: requested task " + taskName + " is not in the MLConfig";
+            logger.log(ERROR, err);
+            std::cerr << err << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    size_t processed = pipeline.run(inputPaths, output_dir);
+
+    std::string msg = "[KAI Batch]-- " + std::to_string(processed) + "/" + std::to_string(inputPaths.size()) +
+                      " image(s) processed, results in " + output_dir;
+    logger.log(INFO, msg);
+    std::cout << msg << std::endl;
+
+    return processed == inputPaths.size() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
 int main(int argc, char** argv) {
     
     // TODO: add logger as input options --log
@@ -24,18 +237,100 @@ int main(int argc, char** argv) {
         return EXIT_FAILURE;
     }
 
-    std::string img_path = parser_getImagePath();
     std::string json_path = parser_getJSONPath();
 
+    // models shared with the other KAI processes on the host
+    if (!parser_getModelCacheDir().empty()) {
+        KAIModelStore::getInstance().setCacheDir(parser_getModelCacheDir());
+    }
+
+    // Server mode: models are loaded once and images are received over HTTP
+    if (parser_isServeMode()) {
+        return runServer(json_path, parser_getServePort(), parser_getDeadlineMs());
+    }
+
+    // Shared-memory mode: frames are read from (and results written to) shm slots
+    if (parser_isShmMode()) {
+        return runShmServer(json_path, parser_getShmName(), parser_getDeadlineMs());
+    }
+
+    // Batch mode: all images of a folder go through the staged pipeline
+    if (parser_isBatchMode()) {
+        return runBatch(json_path, parser_getBatchInputDir(), parser_getBatchOutputDir(), parser_getDeadlineMs());
+    }
+
+    std::string img_path = parser_getImagePath();
+
     // TODO assert that it was provided
     std::string output_path = parser_getOutputPath();
 
+    KAIThreadingPolicy threading = makeThreadingPolicy(1);
+    threading.pinCurrentThread(0);
+
     // Run KAI Task Manager
     KAITaskManager kaiTaskManager;
+    kaiTaskManager.setThreadingPolicy(threading);
+
+    std::unique_ptr<KAIAutoTuner> autoTuner = makeAutoTuner();
+    kaiTaskManager.setAutoTuner(autoTuner.get());
+    kaiTaskManager.setWarmUpRuns(parser_getWarmUpRuns());
     kaiTaskManager.loadMLConfigs(json_path);
 
-    Image img(img_path);
+    // optional latency budget (tasks are dropped or cut short to meet it)
+    // Note: started before the image is decoded, as the HTTP server does on receipt
+    Deadline deadline;
+    int deadline_ms = parser_getDeadlineMs();
+    if (deadline_ms > 0) {
+        deadline = Deadline(std::chrono::milliseconds(deadline_ms));
+    }
+
+    // very large JPEGs are decoded in strips (only a preview and the face regions are kept)
+    std::unique_ptr<Image> pImg;
+    const int stream_mp = parser_getStreamMP();
+    if (stream_mp > 0 && StreamingJpegDecoder::isJpeg(img_path)) {
+        auto decoder = std::make_shared<StreamingJpegDecoder>(img_path);
+        cv::Size fullSize = decoder->getSize();
+        const bool large = static_cast<double>(fullSize.width) * fullSize.height >= stream_mp * 1e6;
+        if (large && decoder->isProgressive()) {
+            // coefficients of the whole image would be buffered: decoded as a whole
+            logger.log(INFO, "[KAI Task Manager]-- " + img_path + " is a progressive JPEG, decoding it as a whole");
+        }
+        else if (large) {
+            size_t pos = img_path.find_last_of('/');
+            std::string img_name = (pos == std::string::npos) ? img_path : img_path.substr(pos + 1);
+            pImg.reset(new Image(decoder, img_name));
+        }
+    }
+    if (!pImg) {
+        pImg.reset(new Image(img_path));
+    }
+    Image& img = *pImg;
+
+    img.setDeadline(deadline);
+
+    // optional output selection (e.g., face boxes only)
+    std::vector<std::string> requested = KAITaskManager::parseTaskList(parser_getRequestedTasks());
+    for (const auto& taskName : requested) {
+        if (!kaiTaskManager.hasTask(taskName)) {
+            std::string err = "[KAI Task Manager]-- Error: requested task " + taskName + " is not in the MLConfig";
+            logger.log(ERROR, err);
+            std::cerr << err << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+    img.setRequestedTasks(requested);
+
     kaiTaskManager.runTasks(img);
+
+    if (img.isPartial()) {
+        std::string partialMsg = "[KAI Task Manager]-- Deadline reached, partial results for task(s):";
+        for (const auto& taskName : img.getPartialTasks()) {
+            partialMsg += " " + taskName;
+        }
+
+        logger.log(INFO, partialMsg);
+        std::cout << partialMsg << std::endl;
+    }
     
     // print results on image
     cv::Mat outMat;
@@ -48,6 +343,12 @@ int main(int argc, char** argv) {
     if(!outMat.empty() && !output_path.empty())
         cv::imwrite(output_path, outMat);
 
+    if (img.isStreaming() && !output_path.empty()) {
+        std::string streamMsg = "[KAI Task Manager]-- Streaming decode: no overlay image (full frame is not kept)";
+        logger.log(INFO, streamMsg);
+        std::cout << streamMsg << std::endl;
+    }
+
     std::string msg = "[KAI Task Manager]-- Process completed successfully!"
                       "\n===================================================";
 
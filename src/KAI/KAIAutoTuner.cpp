@@ -0,0 +1,258 @@
+#include "KAIAutoTuner.h"
+#include "KAITaskInterface.h"
+#include "Logger.h"
+
+#include <opencv2/dnn.hpp>
+
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+using json = nlohmann::json;
+
+namespace {
+    bool sameConfig(const KAIExecConfig& a, const KAIExecConfig& b) {
+        return a.engine == b.engine && a.backendId == b.backendId && a.targetId == b.targetId &&
+               a.numThreads == b.numThreads && a.batchSize == b.batchSize;
+    }
+
+    json toJSON(const KAIExecConfig& config, double msPerFace) {
+        return {{"engine", static_cast<int>(config.engine)},
+                {"backendId", config.backendId},
+                {"targetId", config.targetId},
+                {"numThreads", config.numThreads},
+                {"batchSize", config.batchSize},
+                {"msPerFace", msPerFace}};
+    }
+
+    KAIExecConfig fromJSON(const json& entry) {
+        KAIExecConfig config;
+        config.engine = static_cast<KAIEngine>(entry.value("engine", 0));
+        config.backendId = entry.value("backendId", 0);
+        config.targetId = entry.value("targetId", 0);
+        config.numThreads = entry.value("numThreads", 0);
+        config.batchSize = entry.value("batchSize", 1);
+        return config;
+    }
+}
+
+std::string KAIExecConfig::toString() const
+{
+    std::string str;
+    switch (engine) {
+        case KAIEngine::OpenCVDnn:
+            str = "cv::dnn backend " + std::to_string(backendId) + " target " + std::to_string(targetId);
+            break;
+        case KAIEngine::NativeMLP:
+            str = "native MLP";
+            break;
+        case KAIEngine::TFLite:
+            str = "TFLite";
+            break;
+        case KAIEngine::TFLiteXNNPACK:
+            str = "TFLite+XNNPACK";
+            break;
+    }
+
+    if (numThreads > 0) {
+        str += " " + std::to_string(numThreads) + " thread(s)";
+    }
+    if (batchSize > 1) {
+        str += " batch " + std::to_string(batchSize);
+    }
+    return str;
+}
+
+std::vector<KAIExecConfig> getDnnExecCandidates()
+{
+    std::vector<KAIExecConfig> candidates;
+
+    // OpenCV's own implementation is always available
+    KAIExecConfig opencv;
+    opencv.backendId = cv::dnn::DNN_BACKEND_OPENCV;
+    opencv.targetId = cv::dnn::DNN_TARGET_CPU;
+    candidates.push_back(opencv);
+
+    // e.g. OpenVINO (Inference Engine) if OpenCV was built with it
+    for (const auto& backendTarget : cv::dnn::getAvailableBackends()) {
+        if (backendTarget.second != cv::dnn::DNN_TARGET_CPU ||
+            backendTarget.first == cv::dnn::DNN_BACKEND_OPENCV) {
+            continue;
+        }
+
+        KAIExecConfig config;
+        config.backendId = backendTarget.first;
+        config.targetId = backendTarget.second;
+
+        bool known = false;
+        for (const auto& candidate : candidates) {
+            known = known || sameConfig(candidate, config);
+        }
+        if (!known) {
+            candidates.push_back(config);
+        }
+    }
+    return candidates;
+}
+
+KAIAutoTuner::KAIAutoTuner(const std::string& path, int numIterations)
+    : cachePath(path), iterations(std::max(1, numIterations))
+{
+    machineKey = getCpuModel();
+
+    // previous decisions (all machine types)
+    std::ifstream file(cachePath);
+    if (file) {
+        try {
+            file >> cache;
+        }
+        catch (const std::exception& e) {
+            Logger::getInstance().log(ERROR, "[KAI Auto-Tuner]-- Error: ignoring invalid cache " + cachePath +
+                                             ": " + e.what());
+            cache = json::object();
+        }
+    }
+
+    if (!cache.is_object()) {
+        cache = json::object();
+    }
+}
+
+KAIExecConfig KAIAutoTuner::tune(KAITask& task, const std::string& modelKey)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    Logger& logger = Logger::getInstance();
+
+    std::vector<KAIExecConfig> candidates = task.getExecCandidates();
+    if (candidates.empty()) {
+        return KAIExecConfig();
+    }
+
+    // cached decision (if still supported, e.g. same OpenCV build)
+    if (cache.contains(machineKey) && cache[machineKey].contains(modelKey)) {
+        KAIExecConfig cached = fromJSON(cache[machineKey][modelKey]);
+        for (const auto& candidate : candidates) {
+            if (sameConfig(candidate, cached)) {
+                task.setExecConfig(cached);
+                logger.log(INFO, "[KAI Auto-Tuner]-- " + modelKey + ": " + cached.toString() + " (cached)");
+                return cached;
+            }
+        }
+    }
+
+    // benchmark all candidates
+    KAIExecConfig best = candidates.front();
+    double bestMs = -1.0;
+    for (const auto& candidate : candidates) {
+        double ms = benchmark(task, candidate);
+        logger.log(INFO, "[KAI Auto-Tuner]-- " + modelKey + ": " + candidate.toString() + ": " +
+                         (ms < 0 ? std::string("not supported") : std::to_string(ms) + " ms/face"));
+
+        if (ms >= 0 && (bestMs < 0 || ms < bestMs)) {
+            best = candidate;
+            bestMs = ms;
+        }
+    }
+
+    task.setExecConfig(best);
+
+    if (bestMs < 0) {
+        logger.log(ERROR, "[KAI Auto-Tuner]-- Error: no candidate ran for " + modelKey);
+        return best;
+    }
+
+    logger.log(INFO, "[KAI Auto-Tuner]-- " + modelKey + ": " + best.toString() + " (selected)");
+
+    cache[machineKey][modelKey] = toJSON(best, bestMs);
+    dirty = true;
+    return best;
+}
+
+double KAIAutoTuner::benchmark(KAITask& task, const KAIExecConfig& config)
+{
+    std::vector<double> times;
+    try {
+        task.setExecConfig(config);
+
+        // warm-up (lazy allocations, backend initialization)
+        task.runSynthetic(config.batchSize);
+        task.runSynthetic(config.batchSize);
+
+        for (int i = 0; i < iterations; ++i) {
+            auto start = std::chrono::steady_clock::now();
+            task.runSynthetic(config.batchSize);
+            std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+            times.push_back(elapsed.count() / std::max(1, config.batchSize));
+        }
+    }
+    catch (const std::exception&) {
+        // backend not usable for this model
+        return -1.0;
+    }
+
+    std::nth_element(times.begin(), times.begin() + times.size() / 2, times.end());
+    return times[times.size() / 2];
+}
+
+void KAIAutoTuner::save()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!dirty) {
+        return;
+    }
+
+    // write + rename: readers never see a partial file
+    const std::string tmpPath = cachePath + ".tmp";
+    {
+        std::ofstream file(tmpPath);
+        file << cache.dump(4) << std::endl;
+        if (!file) {
+            Logger::getInstance().log(ERROR, "[KAI Auto-Tuner]-- Error: could not write " + tmpPath);
+            return;
+        }
+    }
+
+    if (std::rename(tmpPath.c_str(), cachePath.c_str()) != 0) {
+        Logger::getInstance().log(ERROR, "[KAI Auto-Tuner]-- Error: could not write " + cachePath);
+        return;
+    }
+    dirty = false;
+}
+
+std::string KAIAutoTuner::getModelKey(const std::string& task, const std::string& modelPath,
+                                      int version, int threads)
+{
+    size_t slash = modelPath.find_last_of('/');
+    std::string fileName = (slash == std::string::npos) ? modelPath : modelPath.substr(slash + 1);
+
+    // file size tells retrained models with the same name/version apart
+    struct stat buffer;
+    long long fileSize = (stat(modelPath.c_str(), &buffer) == 0) ? static_cast<long long>(buffer.st_size) : 0;
+
+    return task + "/" + fileName + "/v" + std::to_string(version) + "/" +
+           std::to_string(fileSize) + "/t" + std::to_string(threads);
+}
+
+std::string KAIAutoTuner::getCpuModel()
+{
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(cpuinfo, line)) {
+        // x86: "model name", some ARM kernels: "Hardware" / "CPU part"
+        if (line.rfind("model name", 0) == 0 || line.rfind("Hardware", 0) == 0) {
+            size_t colon = line.find(':');
+            if (colon != std::string::npos) {
+                std::string model = line.substr(colon + 1);
+                model.erase(0, model.find_first_not_of(" \t"));
+                if (!model.empty()) {
+                    return model;
+                }
+            }
+        }
+    }
+    return "unknown CPU";
+}
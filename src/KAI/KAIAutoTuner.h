@@ -0,0 +1,64 @@
+#ifndef KAIAUTOTUNER_H
+#define KAIAUTOTUNER_H
+
+#include <nlohmann/json.hpp>
+
+#include <mutex>
+#include <string>
+
+#include "KAIExecConfig.h"
+
+class KAITask;
+
+/**
+ * @brief Startup auto-tuner: fastest execution settings per task
+ * @note  Each candidate of KAITask::getExecCandidates (cv::dnn backends, native vs. dnn
+ *        face pose, TFLite threads / XNNPACK / batch size) is benchmarked on synthetic
+ *        input (KAITask::runSynthetic) and the fastest (time per face) is applied.
+ *        Decisions are cached in a JSON file keyed by CPU model and model (task, file,
+ *        version, size, threads), so each machine type tunes once:
+ *
+ *        {"<cpu model>": {"<model key>": {"engine": 0, "backendId": 3, ..., "msPerFace": 2.1}}}
+ *
+ *        KAIAutoTuner tuner("kai_tuning.json");
+ *        manager.setAutoTuner(&tuner);
+ *        manager.loadMLConfigs(configPath); // tunes (or reads the cache), then saves it
+ *
+ * @note  Thread safe: task managers loading in parallel tune one task at a time, so
+ *        benchmarks do not compete for the cores (later instances hit the cache).
+ */
+class KAIAutoTuner {
+public:
+    // cachePath: JSON file with the decisions (created if missing)
+    explicit KAIAutoTuner(const std::string& cachePath, int iterations = 10);
+
+    /**
+     * @brief select and apply the fastest execution settings of <task>
+     * @param modelKey - identifies the model (see getModelKey)
+     * @return selected settings (task defaults if the task is not tunable)
+     */
+    KAIExecConfig tune(KAITask& task, const std::string& modelKey);
+
+    // write the decisions to the cache file
+    void save();
+
+    // "<task>/<model file>/v<version>/<file size>/t<threads>"
+    static std::string getModelKey(const std::string& task, const std::string& modelPath,
+                                   int version, int threads);
+
+    // CPU model name (/proc/cpuinfo)
+    static std::string getCpuModel();
+
+private:
+    // median time per face (ms) of <config>, < 0 if the settings are not supported
+    double benchmark(KAITask& task, const KAIExecConfig& config);
+
+    std::string cachePath;
+    int iterations;
+
+    std::mutex mutex;
+    nlohmann::json cache;    // all machines
+    std::string machineKey;  // this machine's CPU model
+    bool dirty = false;      // new decisions not saved yet
+};
+#endif // KAIAUTOTUNER_H
@@ -0,0 +1,360 @@
+#include "KAIBatchPipeline.h"
+#include "KAIResults.h"
+#include "Logger.h"
+
+#include <dirent.h>
+
+#include <algorithm>
+#include <cctype>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <thread>
+
+namespace {
+    std::string toLower(std::string str) {
+        std::transform(str.begin(), str.end(), str.begin(),
+                       [](unsigned char c) {return static_cast<char>(std::tolower(c));});
+        return str;
+    }
+
+    // run <count> workers of a stage, then close the stage's output queue
+    // Note: the output queue is disabled once it is drained, which releases the
+    //       (blocked) workers of the next stage
+    std::vector<std::thread> startStage(int count, const std::function<void()>& worker) {
+        std::vector<std::thread> threads;
+        for (int i = 0; i < std::max(1, count); ++i) {
+            threads.emplace_back(worker);
+        }
+        return threads;
+    }
+
+    template <typename Queue>
+    void finishStage(std::vector<std::thread>& threads, Queue* output) {
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        if (output != nullptr) {
+            output->wait_until_empty();
+            output->disable();
+        }
+    }
+}
+
+KAIBatchPipeline::KAIBatchPipeline(const std::string& configPath, const Config& cfg)
+    : config(cfg)
+{
+    const int instances = std::max(1, config.inferenceInstances);
+    config.threading.interImageWorkers = instances;
+
+    // thread counts and core slices from the process' cores, not from a pinned loader's slice
+    config.threading.captureCores();
+
+    // each instance is loaded by a thread on its own cores, so that the thread pools of
+    // its tasks (created at load) and its model memory (first touch) are local to them
+    managers.resize(static_cast<size_t>(instances));
+    std::vector<std::exception_ptr> errors(managers.size());
+    std::vector<std::thread> loaders;
+    for (int i = 0; i < instances; ++i) {
+        loaders.emplace_back([&, i] {
+            try {
+                config.threading.pinCurrentThread(i);
+
+                std::unique_ptr<KAITaskManager> manager(new KAITaskManager);
+                manager->setThreadingPolicy(config.threading);
+                manager->setAutoTuner(config.autoTuner);
+                manager->setWarmUpRuns(config.warmUpRuns);
+                manager->loadMLConfigs(configPath);
+                managers[i] = std::move(manager);
+            }
+            catch (...) {
+                errors[i] = std::current_exception();
+            }
+        });
+    }
+    for (auto& loader : loaders) {
+        loader.join();
+    }
+    for (const auto& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    if (config.memoryBudgetMB > 0) {
+        memoryBudget.reset(new KAIMemoryBudget(config.memoryBudgetMB * 1024 * 1024));
+    }
+}
+
+bool KAIBatchPipeline::hasTask(const std::string& name) const
+{
+    // all instances load the same MLConfig
+    return managers.front()->hasTask(name);
+}
+
+std::vector<std::string> KAIBatchPipeline::listImages(const std::string& dir)
+{
+    static const std::vector<std::string> extensions = {".jpg", ".jpeg", ".png", ".bmp", ".tif", ".tiff"};
+
+    std::vector<std::string> paths;
+    DIR* dp = opendir(dir.c_str());
+    if (dp == nullptr) {
+        return paths;
+    }
+
+    while (dirent* entry = readdir(dp)) {
+        std::string name = entry->d_name;
+        size_t dot = name.find_last_of('.');
+        if (dot == std::string::npos) {
+            continue;
+        }
+
+        // skip our own outputs
+        if (name.find("_KAI.") != std::string::npos) {
+            continue;
+        }
+
+        std::string ext = toLower(name.substr(dot));
+        if (std::find(extensions.begin(), extensions.end(), ext) != extensions.end()) {
+            paths.push_back(dir + "/" + name);
+        }
+    }
+    closedir(dp);
+
+    std::sort(paths.begin(), paths.end());
+    return paths;
+}
+
+size_t KAIBatchPipeline::run(const std::vector<std::string>& inputPaths, const std::string& outputDir)
+{
+    Logger& logger = Logger::getInstance();
+    logger.log(INFO, "[KAI Batch]-- Processing " + std::to_string(inputPaths.size()) + " image(s)");
+
+    numProcessed = 0;
+    numFailed = 0;
+
+    // bounded queues between the stages
+    Queue pathQueue(config.queueDepth);
+    Queue readQueue(config.queueDepth);
+    Queue decodeQueue(config.queueDepth);
+    Queue inferenceQueue(config.queueDepth);
+    Queue encodeQueue(config.queueDepth);
+
+    auto readers = startStage(config.readThreads, [&] {readStage(pathQueue, readQueue);});
+    auto decoders = startStage(config.decodeThreads, [&] {decodeStage(readQueue, decodeQueue);});
+
+    std::vector<std::thread> inferenceWorkers;
+    for (int i = 0; i < static_cast<int>(managers.size()); ++i) {
+        inferenceWorkers.emplace_back([&, i] {inferenceStage(i, decodeQueue, inferenceQueue);});
+    }
+
+    auto encoders = startStage(config.encodeThreads, [&] {encodeStage(inferenceQueue, encodeQueue);});
+    auto writers = startStage(config.writeThreads, [&] {writeStage(encodeQueue);});
+
+    // feed the pipeline (blocks while the read stage is saturated)
+    for (const auto& path : inputPaths) {
+        ItemPtr item = std::make_shared<BatchItem>();
+        item->inputPath = path;
+
+        // <outputDir>/<name>_KAI.<ext>
+        size_t slash = path.find_last_of('/');
+        std::string fileName = (slash == std::string::npos) ? path : path.substr(slash + 1);
+        size_t dot = fileName.find_last_of('.');
+        item->outputBase = outputDir + "/" + fileName.substr(0, dot) + "_KAI";
+        item->extension = (dot == std::string::npos) ? ".jpg" : fileName.substr(dot);
+
+        pathQueue.enqueue(item);
+    }
+    pathQueue.wait_until_empty();
+    pathQueue.disable();
+
+    // drain the stages in order
+    finishStage(readers, &readQueue);
+    finishStage(decoders, &decodeQueue);
+    finishStage(inferenceWorkers, &inferenceQueue);
+    finishStage(encoders, &encodeQueue);
+    finishStage(writers, static_cast<Queue*>(nullptr));
+
+    logger.log(INFO, "[KAI Batch]-- Done: " + std::to_string(numProcessed.load()) + " processed, " +
+                     std::to_string(numFailed.load()) + " failed");
+
+    return numProcessed;
+}
+
+void KAIBatchPipeline::readStage(Queue& input, Queue& output)
+{
+    ItemPtr item;
+    while (input.dequeue(item)) {
+        std::ifstream file(item->inputPath, std::ios::binary | std::ios::ate);
+        if (!file) {
+            reportFailure(*item, "could not open file");
+            continue;
+        }
+
+        std::streamsize size = file.tellg();
+        file.seekg(0, std::ios::beg);
+        item->bytes.resize(static_cast<size_t>(std::max<std::streamsize>(size, 0)));
+        if (size <= 0 || !file.read(reinterpret_cast<char*>(item->bytes.data()), size)) {
+            reportFailure(*item, "could not read file");
+            continue;
+        }
+
+        output.enqueue(item);
+    }
+}
+
+void KAIBatchPipeline::decodeStage(Queue& input, Queue& output)
+{
+    ItemPtr item;
+    while (input.dequeue(item)) {
+        size_t slash = item->inputPath.find_last_of('/');
+        std::string name = (slash == std::string::npos) ? item->inputPath : item->inputPath.substr(slash + 1);
+
+        int width = 0, height = 0;
+        KAIMemoryBudget::probeImageHeader(item->bytes.data(), item->bytes.size(), width, height);
+
+        // very large JPEGs: strip-wise decoding (preview + face regions)
+        if (config.streamingMinMP > 0 && StreamingJpegDecoder::isJpeg(item->bytes.data(), item->bytes.size()) &&
+            static_cast<double>(width) * height >= config.streamingMinMP * 1e6) {
+            
+            // preview long side < 2048 (decodePreview(1024))
+            if (memoryBudget) {
+                const float previewScale = std::min(1.0f, 2048.0f / std::max(width, height));
+                item->memory = memoryBudget->acquire(memoryBudget->estimate(static_cast<int>(width * previewScale),
+                                                                            static_cast<int>(height * previewScale)));
+            }
+
+            try {
+                auto decoder = std::make_shared<StreamingJpegDecoder>(std::move(item->bytes));
+                if (!decoder->isProgressive()) {
+                    item->image.reset(new Image(decoder, name));
+                }
+                else {
+                    // coefficients of the whole image would be buffered: decoded as a whole below
+                    item->bytes = decoder->takeBytes();
+                    item->memory.release();
+                }
+            }
+            catch (const std::exception& e) {
+                reportFailure(*item, e.what());
+                continue;
+            }
+
+            if (item->image) {
+                output.enqueue(item);
+                continue;
+            }
+        }
+
+        // wait until the decoded image fits the memory budget (estimated from the header)
+        if (memoryBudget) {
+            item->memory = memoryBudget->acquire(memoryBudget->estimateEncoded(item->bytes.data(), item->bytes.size()));
+        }
+
+        cv::Mat imgMat = cv::imdecode(item->bytes, cv::IMREAD_COLOR);
+
+        // encoded bytes are no longer needed
+        std::vector<uchar>().swap(item->bytes);
+
+        if (imgMat.empty()) {
+            reportFailure(*item, "could not decode image");
+            continue;
+        }
+
+        item->image.reset(new Image(imgMat, name));
+
+        output.enqueue(item);
+    }
+}
+
+void KAIBatchPipeline::inferenceStage(int instance, Queue& input, Queue& output)
+{
+    KAITaskManager& manager = *managers[instance];
+    config.threading.pinCurrentThread(instance);
+
+    ItemPtr item;
+    while (input.dequeue(item)) {
+        // budget covers inference only (queueing time is not charged to the image)
+        if (config.deadlineMs > 0) {
+            item->image->setDeadline(Deadline(std::chrono::milliseconds(config.deadlineMs)));
+        }
+        item->image->setRequestedTasks(config.requestedTasks);
+
+        try {
+            manager.runTasks(*item->image);
+        }
+        catch (const std::exception& e) {
+            reportFailure(*item, e.what());
+            continue;
+        }
+
+        output.enqueue(item);
+    }
+}
+
+void KAIBatchPipeline::encodeStage(Queue& input, Queue& output)
+{
+    ItemPtr item;
+    while (input.dequeue(item)) {
+        Image& img = *item->image;
+
+        if (config.writeJSON) {
+            item->results = imageResultsToJSON(img).dump();
+        }
+
+        // streaming images keep no full frame to draw on
+        if (config.writeOverlay && !img.isStreaming()) {
+            // draw results (same overlay as the single image mode)
+            cv::Mat outMat;
+            img.getImage_faceOn(outMat);
+            img.getImage_faceFeaturesOn(outMat);
+
+            if (outMat.empty() || !cv::imencode(item->extension, outMat, item->encoded)) {
+                reportFailure(*item, "could not encode overlay image");
+                continue;
+            }
+        }
+
+        // release the decoded image before the (slow) write stage
+        item->image.reset();
+        item->memory.release();
+
+        output.enqueue(item);
+    }
+}
+
+void KAIBatchPipeline::writeStage(Queue& input)
+{
+    ItemPtr item;
+    while (input.dequeue(item)) {
+        bool written = true;
+
+        if (config.writeOverlay && !item->encoded.empty()) {
+            std::ofstream file(item->outputBase + item->extension, std::ios::binary);
+            written = written && file.write(reinterpret_cast<const char*>(item->encoded.data()),
+                                            static_cast<std::streamsize>(item->encoded.size()));
+        }
+
+        if (config.writeJSON) {
+            std::ofstream file(item->outputBase + ".json");
+            written = written && (file << item->results);
+        }
+
+        if (!written) {
+            reportFailure(*item, "could not write results");
+            continue;
+        }
+
+        ++numProcessed;
+    }
+}
+
+void KAIBatchPipeline::reportFailure(const BatchItem& item, const std::string& message)
+{
+    ++numFailed;
+
+    std::string msg = "[KAI Batch]-- Error: " + item.inputPath + ": " + message;
+    Logger::getInstance().log(ERROR, msg);
+    std::cerr << msg << std::endl;
+}
@@ -0,0 +1,102 @@
+#ifndef KAIBATCHPIPELINE_H
+#define KAIBATCHPIPELINE_H
+
+#include <dlib/pipe.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "KAIMemoryBudget.h"
+#include "KAITaskManager.h"
+#include "KAIThreadingPolicy.h"
+
+/**
+ * @brief Staged batch processing of image files
+ * @note  read (I/O prefetch) -> decode -> inference -> render/encode -> write
+ *        Stages are connected by bounded queues (dlib::pipe): a full queue blocks its
+ *        producers (backpressure), so at most ~queueDepth images wait between two stages.
+ *        Each stage has its own worker pool, so disk I/O, decoding and encoding overlap
+ *        with inference.
+ *        With a memory budget, the decode stage admits an image only once its estimated
+ *        memory (from the header) fits; the reservation is held until the image is released.
+ *        Very large JPEGs can be decoded in strips (preview + face regions only, no overlay).
+ *        Inference instance i loads its models and runs on the cores of worker i of the
+ *        threading policy (pinned if enabled), so instances do not oversubscribe the cores.
+ */
+class KAIBatchPipeline {
+public:
+
+    struct Config {
+        int readThreads = 1;
+        int decodeThreads = 2;
+        int inferenceInstances = 1; // independent task managers (models loaded per instance)
+        int encodeThreads = 1;
+        int writeThreads = 1;
+        size_t queueDepth = 4;      // max. images waiting between two stages
+        size_t memoryBudgetMB = 0;  // memory for decoded images in flight (0: unlimited)
+        int streamingMinMP = 0;     // JPEGs with >= streamingMinMP megapixels are decoded in strips (0: off)
+        int deadlineMs = 0;         // per-image latency budget (0: none)
+        std::vector<std::string> requestedTasks; // outputs to compute (empty: all tasks)
+        bool writeOverlay = true;   // <name>_KAI.<ext> with results drawn
+        bool writeJSON = true;      // <name>_KAI.json
+        KAIThreadingPolicy threading; // inter-image workers == inferenceInstances
+        KAIAutoTuner* autoTuner = nullptr; // startup auto-tuning (not owned)
+        int warmUpRuns = 1;         // synthetic inference runs per task at load time
+    };
+
+    KAIBatchPipeline(const std::string& configPath, const Config& cfg);
+
+    /**
+     * @brief process all <inputPaths>, writing results to <outputDir>
+     * @return number of images processed successfully
+     */
+    size_t run(const std::vector<std::string>& inputPaths, const std::string& outputDir);
+
+    // true if the pipeline has task <name> (e.g., to validate requested outputs)
+    bool hasTask(const std::string& name) const;
+
+    // image files (jpg, jpeg, png, bmp, tif, tiff) in <dir>, sorted by name
+    static std::vector<std::string> listImages(const std::string& dir);
+
+private:
+
+    // one image travelling through the stages
+    struct BatchItem {
+        std::string inputPath;
+        std::string outputBase;              // output path without extension
+        std::string extension;               // output image extension (e.g., ".jpg")
+        std::vector<uchar> bytes;            // encoded input (read stage)
+        std::unique_ptr<Image> image;        // decoded image + results
+        KAIMemoryBudget::Reservation memory; // held while the image is decoded
+        std::vector<uchar> encoded;          // encoded overlay (encode stage)
+        std::string results;                 // JSON results
+    };
+
+    using ItemPtr = std::shared_ptr<BatchItem>;
+    using Queue = dlib::pipe<ItemPtr>;
+
+    Config config;
+
+    // one task manager per inference worker (tasks own their inference state)
+    std::vector<std::unique_ptr<KAITaskManager>> managers;
+
+    // admission control of decoded images (nullptr: unlimited)
+    std::unique_ptr<KAIMemoryBudget> memoryBudget;
+
+    std::atomic<size_t> numProcessed{0};
+    std::atomic<size_t> numFailed{0};
+
+    ///
+    // stages
+    ///
+    void readStage(Queue& input, Queue& output);
+    void decodeStage(Queue& input, Queue& output);
+    void inferenceStage(int instance, Queue& input, Queue& output);
+    void encodeStage(Queue& input, Queue& output);
+    void writeStage(Queue& input);
+
+    void reportFailure(const BatchItem& item, const std::string& message);
+};
+#endif // KAIBATCHPIPELINE_H
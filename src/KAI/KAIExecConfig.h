@@ -0,0 +1,34 @@
+#ifndef KAIEXECCONFIG_H
+#define KAIEXECCONFIG_H
+
+#include <string>
+#include <vector>
+
+// Inference engine of a task's model
+enum class KAIEngine {
+    OpenCVDnn = 0,      // cv::dnn (backendId/targetId)
+    NativeMLP = 1,      // DenseMLP (face pose)
+    TFLite = 2,         // TFLite built-in kernels
+    TFLiteXNNPACK = 3   // TFLite with the XNNPACK delegate
+};
+
+/**
+ * @brief Execution settings of a task's model (selected by the auto-tuner)
+ * @note  Tasks list the settings they support (KAITask::getExecCandidates) and
+ *        apply the selected one (KAITask::setExecConfig).
+ */
+struct KAIExecConfig {
+    KAIEngine engine = KAIEngine::OpenCVDnn;
+    int backendId = 0;  // cv::dnn::Backend (0: default)
+    int targetId = 0;   // cv::dnn::Target (0: CPU)
+    int numThreads = 0; // intra-op threads (0: threading policy)
+    int batchSize = 1;  // max. faces per inference call
+
+    // e.g. "cv::dnn backend 3 target 0", "TFLite+XNNPACK 4 thread(s) batch 8"
+    std::string toString() const;
+};
+
+// cv::dnn backends available on the CPU target in this OpenCV build
+std::vector<KAIExecConfig> getDnnExecCandidates();
+
+#endif // KAIEXECCONFIG_H
@@ -0,0 +1,177 @@
+#include "KAIHttpHandler.h"
+#include "KAIResults.h"
+#include "Logger.h"
+
+#include <dlib/base64.h>
+
+#include <algorithm>
+#include <sstream>
+
+std::string KAIHttpHandler::handleRequest(const dlib::incoming_things& incoming,
+                                          dlib::outgoing_things& outgoing)
+{
+    outgoing.headers["Content-Type"] = "application/json";
+
+    // readiness: models loaded and warmed up
+    if (incoming.path == "/health") {
+        if (!taskManager.isReady()) {
+            outgoing.http_return = 503;
+            outgoing.http_return_status = "Service Unavailable";
+            return json{{"status", "loading"}}.dump();
+        }
+        return json{{"status", "ok"}}.dump();
+    }
+
+    if (incoming.path == "/process") {
+        if (incoming.request_type != "POST" && incoming.request_type != "PUT") {
+            return errorResponse(outgoing, 405, "Use POST with the encoded image in the request body");
+        }
+
+        if (!taskManager.isReady()) {
+            return errorResponse(outgoing, 503, "Models are loading");
+        }
+
+        try {
+            return processImage(incoming, outgoing);
+        }
+        catch (const std::exception& e) {
+            Logger::getInstance().log(ERROR, "[KAI Server]-- Error: " + std::string(e.what()));
+            return errorResponse(outgoing, 500, e.what());
+        }
+    }
+
+    // hot reload of the MLConfig (changed modules only)
+    if (incoming.path == "/reload") {
+        if (incoming.request_type != "POST") {
+            return errorResponse(outgoing, 405, "Use POST to reload the MLConfig");
+        }
+
+        try {
+            taskManager.reloadMLConfigs();
+        }
+        catch (const std::exception& e) {
+            Logger::getInstance().log(ERROR, "[KAI Server]-- Error: reload failed: " + std::string(e.what()));
+            return errorResponse(outgoing, 500, e.what());
+        }
+        return json{{"status", "reloaded"}}.dump();
+    }
+
+    return errorResponse(outgoing, 404, "Not Found");
+}
+
+std::string KAIHttpHandler::processImage(const dlib::incoming_things& incoming,
+                                         dlib::outgoing_things& outgoing)
+{
+    if (incoming.body.empty()) {
+        return errorResponse(outgoing, 400, "Empty request body (expected encoded image bytes)");
+    }
+
+    // request options
+    int deadlineMs = defaultDeadlineMs;
+    if (!incoming.queries["deadline"].empty()) {
+        try {
+            deadlineMs = std::stoi(incoming.queries["deadline"]);
+        }
+        catch (const std::exception&) {
+            return errorResponse(outgoing, 400, "Invalid value for deadline (expected ms)");
+        }
+    }
+
+    const std::string overlayFormat = incoming.queries["overlay"];
+    if (!overlayFormat.empty() && overlayFormat != "jpg" && overlayFormat != "png") {
+        return errorResponse(outgoing, 400, "Invalid overlay format (expected jpg or png)");
+    }
+
+    const bool includeLandmarks = incoming.queries["landmarks"] != "0";
+
+    // output selection (empty: all tasks)
+    std::vector<std::string> requestedTasks = KAITaskManager::parseTaskList(incoming.queries["tasks"]);
+    for (const auto& taskName : requestedTasks) {
+        if (!taskManager.hasTask(taskName)) {
+            return errorResponse(outgoing, 400, "Unknown task " + taskName + " (not in the MLConfig)");
+        }
+    }
+
+    const std::string priorityName = incoming.queries["priority"];
+    if (!priorityName.empty() && priorityName != "interactive" && priorityName != "bulk") {
+        return errorResponse(outgoing, 400, "Invalid priority (expected interactive or bulk)");
+    }
+    const KAIPriority priority = parsePriority(priorityName);
+
+    // budget starts when the request is received (includes decode and queueing)
+    Deadline deadline;
+    if (deadlineMs > 0) {
+        deadline = Deadline(std::chrono::milliseconds(deadlineMs));
+    }
+
+    // wait until the decoded image fits the memory budget (size from the image header)
+    KAIMemoryBudget::Reservation memory;
+    if (memoryBudget != nullptr) {
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(incoming.body.data());
+        if (!memoryBudget->acquire(memoryBudget->estimateEncoded(bytes, incoming.body.size()), deadline, memory)) {
+            return errorResponse(outgoing, 503, "Memory budget exhausted before the deadline");
+        }
+    }
+
+    // decode image from memory (no copy of the request body)
+    cv::Mat buffer(1, static_cast<int>(incoming.body.size()), CV_8UC1,
+                   const_cast<char*>(incoming.body.data()));
+    cv::Mat imgMat = cv::imdecode(buffer, cv::IMREAD_COLOR);
+    if (imgMat.empty()) {
+        return errorResponse(outgoing, 415, "Could not decode the image");
+    }
+
+    std::string imgName = incoming.queries["name"].empty() ? "request" : incoming.queries["name"];
+    Image img(imgMat, imgName);
+    img.setDeadline(deadline);
+    img.setRequestedTasks(requestedTasks);
+
+    {
+        KAIPriorityScheduler::Lease lease = scheduler.acquire(priority);
+        img.setTaskBoundaryHook([&lease] {lease.yieldPoint();});
+        taskManager.runTasks(img);
+        img.setTaskBoundaryHook(nullptr);
+    }
+
+    json results = imageResultsToJSON(img, includeLandmarks);
+
+    // optional overlay image (base64 encoded)
+    if (!overlayFormat.empty()) {
+        cv::Mat outMat;
+        img.getImage_faceOn(outMat);
+        img.getImage_faceFeaturesOn(outMat);
+
+        std::vector<uchar> encoded;
+        if (!outMat.empty() && cv::imencode("." + overlayFormat, outMat, encoded)) {
+            std::istringstream sin(std::string(encoded.begin(), encoded.end()));
+            std::ostringstream sout;
+            dlib::base64 base64Coder;
+            base64Coder.set_line_ending(dlib::base64::LF);
+            base64Coder.encode(sin, sout);
+
+            // drop line breaks added by the encoder
+            std::string overlay = sout.str();
+            overlay.erase(std::remove(overlay.begin(), overlay.end(), '\n'), overlay.end());
+
+            results["overlay"] = overlay;
+            results["overlayFormat"] = overlayFormat;
+        }
+    }
+
+    return results.dump();
+}
+
+std::string KAIHttpHandler::errorResponse(dlib::outgoing_things& outgoing,
+                                          unsigned short status, const std::string& message)
+{
+    outgoing.http_return = status;
+    switch (status) {
+        case 400: outgoing.http_return_status = "Bad Request"; break;
+        case 404: outgoing.http_return_status = "Not Found"; break;
+        case 405: outgoing.http_return_status = "Method Not Allowed"; break;
+        case 415: outgoing.http_return_status = "Unsupported Media Type"; break;
+        case 503: outgoing.http_return_status = "Service Unavailable"; break;
+        default:  outgoing.http_return_status = "Internal Server Error"; break;
+    }
+    return json{{"error", message}}.dump();
+}
@@ -0,0 +1,68 @@
+#ifndef KAIHTTPHANDLER_H
+#define KAIHTTPHANDLER_H
+
+#include <dlib/server.h>
+
+#include <string>
+
+#include "KAIMemoryBudget.h"
+#include "KAIPriorityScheduler.h"
+#include "KAITaskManager.h"
+
+/**
+ * @brief KAI HTTP API (independent of the connection handling)
+ * @note  Images are received in the request body, decoded in memory and processed by the
+ *        resident pipeline (models are loaded once); no temp files or process spawn per request.
+ *
+ *  GET  /health                       -> {"status": "ok"} (503 {"status": "loading"} until the
+ *                                        models are loaded and warmed up)
+ *  POST /process[?deadline=<ms>]      -> JSON results (see KAIResults.h)
+ *               [&overlay=jpg|png]       + base64 encoded overlay image ("overlay")
+ *               [&landmarks=0]           - without facial feature points
+ *               [&tasks=<name,...>]      - compute these outputs only (e.g. "FaceDetection,Smile";
+ *                                          prerequisites such as landmarks run as needed)
+ *               [&priority=bulk]         - bulk traffic (default: interactive); yields to
+ *                                          interactive requests between tasks
+ *       body: encoded image bytes (jpg, png, ...)
+ *  POST /reload                       -> {"status": "reloaded"} once the MLConfig is reloaded
+ *                                        (requests keep running meanwhile; 500 and the
+ *                                        current pipeline is kept if the config is invalid)
+ *
+ * @note  Thread safe: requests may be handled from any thread.
+ */
+class KAIHttpHandler {
+public:
+    explicit KAIHttpHandler(KAITaskManager& manager): taskManager(manager) {}
+
+    // latency budget for requests without a "deadline" query (0: no deadline)
+    void setDefaultDeadlineMs(int ms) {defaultDeadlineMs = ms;}
+
+    // admission control: requests wait until their decoded image fits the budget
+    // (503 if the deadline expires first); nullptr: unlimited
+    void setMemoryBudget(KAIMemoryBudget* budget) {memoryBudget = budget;}
+
+    // handle a parsed request, returns the response body
+    std::string handleRequest(const dlib::incoming_things& incoming,
+                              dlib::outgoing_things& outgoing);
+
+private:
+
+    // POST /process
+    std::string processImage(const dlib::incoming_things& incoming,
+                             dlib::outgoing_things& outgoing);
+
+    // set an error status and return the JSON error message
+    static std::string errorResponse(dlib::outgoing_things& outgoing,
+                                     unsigned short status, const std::string& message);
+
+    KAITaskManager& taskManager;
+
+    // tasks own their inference state (nets, scratch buffers),
+    // so the resident pipeline processes one image at a time
+    // (interactive requests first, bulk requests paused between tasks)
+    KAIPriorityScheduler scheduler{1};
+
+    int defaultDeadlineMs = 0;
+    KAIMemoryBudget* memoryBudget = nullptr;
+};
+#endif // KAIHTTPHANDLER_H
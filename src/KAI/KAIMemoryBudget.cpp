@@ -0,0 +1,227 @@
+#include "KAIMemoryBudget.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+    uint32_t readBE16(const uint8_t* p) {return (uint32_t(p[0]) << 8) | p[1];}
+    uint32_t readBE32(const uint8_t* p) {return (readBE16(p) << 16) | readBE16(p + 2);}
+    uint32_t readLE16(const uint8_t* p) {return (uint32_t(p[1]) << 8) | p[0];}
+    uint32_t readLE32(const uint8_t* p) {return (readLE16(p + 2) << 16) | readLE16(p);}
+
+    // JPEG: size from the first start-of-frame segment
+    bool probeJPEG(const uint8_t* data, size_t size, int& width, int& height) {
+        size_t pos = 2; // after SOI
+        while (pos + 4 <= size) {
+            if (data[pos] != 0xFF) {
+                return false;
+            }
+            uint8_t marker = data[pos + 1];
+            if (marker == 0xFF) {
+                ++pos; // fill byte
+                continue;
+            }
+            if (marker == 0x01 || (marker >= 0xD0 && marker <= 0xD7)) {
+                pos += 2; // markers without payload
+                continue;
+            }
+
+            size_t length = readBE16(data + pos + 2);
+
+            // SOF0..SOF15, except DHT (C4), JPG (C8) and DAC (CC)
+            if (marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC) {
+                if (pos + 9 > size) {
+                    return false;
+                }
+                height = static_cast<int>(readBE16(data + pos + 5));
+                width = static_cast<int>(readBE16(data + pos + 7));
+                return true;
+            }
+
+            if (marker == 0xDA || length < 2) {
+                return false; // start of scan before any frame header
+            }
+            pos += 2 + length;
+        }
+        return false;
+    }
+
+    // TIFF: size from the first image file directory
+    bool probeTIFF(const uint8_t* data, size_t size, int& width, int& height) {
+        const bool le = data[0] == 'I';
+        auto read16 = [le](const uint8_t* p) {return le ? readLE16(p) : readBE16(p);};
+        auto read32 = [le](const uint8_t* p) {return le ? readLE32(p) : readBE32(p);};
+
+        size_t ifd = read32(data + 4);
+        if (ifd + 2 > size) {
+            return false;
+        }
+
+        width = height = 0;
+        size_t count = read16(data + ifd);
+        for (size_t i = 0; i < count; ++i) {
+            const uint8_t* entry = data + ifd + 2 + i * 12;
+            if (entry + 12 > data + size) {
+                break;
+            }
+
+            uint32_t tag = read16(entry);
+            uint32_t type = read16(entry + 2);
+            uint32_t value = (type == 3) ? read16(entry + 8) : read32(entry + 8); // SHORT or LONG
+            if (tag == 256) {
+                width = static_cast<int>(value);
+            }
+            else if (tag == 257) {
+                height = static_cast<int>(value);
+            }
+        }
+        return width > 0 && height > 0;
+    }
+}
+
+///
+// Reservation
+///
+KAIMemoryBudget::Reservation& KAIMemoryBudget::Reservation::operator=(Reservation&& other) noexcept
+{
+    if (this != &other) {
+        release();
+        budget = other.budget;
+        reservedBytes = other.reservedBytes;
+        other.budget = nullptr;
+        other.reservedBytes = 0;
+    }
+    return *this;
+}
+
+void KAIMemoryBudget::Reservation::release()
+{
+    if (budget != nullptr) {
+        budget->release(reservedBytes);
+        budget = nullptr;
+        reservedBytes = 0;
+    }
+}
+
+///
+// KAIMemoryBudget
+///
+KAIMemoryBudget::KAIMemoryBudget(size_t bytes, double copiesPerImage)
+    : budgetBytes(bytes), copies(std::max(1.0, copiesPerImage))
+{
+}
+
+size_t KAIMemoryBudget::inUse() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return usedBytes;
+}
+
+size_t KAIMemoryBudget::estimate(int width, int height) const
+{
+    // decoded as 8-bit BGR (cv::IMREAD_COLOR)
+    const double decodedBytes = static_cast<double>(std::max(width, 0)) * std::max(height, 0) * 3;
+    return static_cast<size_t>(decodedBytes * copies);
+}
+
+size_t KAIMemoryBudget::estimateEncoded(const uint8_t* data, size_t size) const
+{
+    int width = 0, height = 0;
+    if (!probeImageHeader(data, size, width, height)) {
+        return budgetBytes;
+    }
+    return estimate(width, height);
+}
+
+bool KAIMemoryBudget::probeImageHeader(const uint8_t* data, size_t size, int& width, int& height)
+{
+    if (data == nullptr) {
+        return false;
+    }
+
+    // JPEG (SOI)
+    if (size >= 4 && data[0] == 0xFF && data[1] == 0xD8) {
+        return probeJPEG(data, size, width, height);
+    }
+
+    // PNG (signature + IHDR)
+    static const uint8_t pngSignature[8] = {0x89, 'P', 'N', 'G', 0x0D, 0x0A, 0x1A, 0x0A};
+    if (size >= 24 && std::memcmp(data, pngSignature, 8) == 0) {
+        width = static_cast<int>(readBE32(data + 16));
+        height = static_cast<int>(readBE32(data + 20));
+        return width > 0 && height > 0;
+    }
+
+    // BMP (BITMAPINFOHEADER, negative height: top-down rows)
+    if (size >= 26 && data[0] == 'B' && data[1] == 'M') {
+        width = static_cast<int>(static_cast<int32_t>(readLE32(data + 18)));
+        height = std::abs(static_cast<int>(static_cast<int32_t>(readLE32(data + 22))));
+        return width > 0 && height > 0;
+    }
+
+    // TIFF (II*\0 or MM\0*)
+    if (size >= 8 && ((data[0] == 'I' && data[1] == 'I' && data[2] == 42 && data[3] == 0) ||
+                      (data[0] == 'M' && data[1] == 'M' && data[2] == 0 && data[3] == 42))) {
+        return probeTIFF(data, size, width, height);
+    }
+
+    return false;
+}
+
+KAIMemoryBudget::Reservation KAIMemoryBudget::acquire(size_t bytes)
+{
+    Reservation reservation;
+    acquire(bytes, Deadline(), reservation);
+    return reservation;
+}
+
+bool KAIMemoryBudget::acquire(size_t bytes, const Deadline& deadline, Reservation& reservation)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+
+    // first in line and fits (or nothing else in flight)
+    const void* ticket = &reservation;
+    waiting.push_back(ticket);
+    auto admissible = [&] {
+        return waiting.front() == ticket && (usedBytes == 0 || usedBytes + bytes <= budgetBytes);
+    };
+
+    while (!admissible()) {
+        if (!deadline.isBounded()) {
+            released.wait(lock);
+        }
+        else if (deadline.expired() ||
+                 released.wait_for(lock, std::chrono::duration<double, std::milli>(deadline.remainingMs())) ==
+                     std::cv_status::timeout) {
+            if (admissible()) {
+                break;
+            }
+
+            // give up (the next waiter may be admissible now)
+            waiting.erase(std::find(waiting.begin(), waiting.end(), ticket));
+            released.notify_all();
+            return false;
+        }
+    }
+
+    waiting.pop_front();
+    usedBytes += bytes;
+    lock.unlock();
+
+    // the next waiter may fit as well
+    released.notify_all();
+
+    reservation = Reservation(this, bytes);
+    return true;
+}
+
+void KAIMemoryBudget::release(size_t bytes)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        usedBytes -= std::min(bytes, usedBytes);
+    }
+    released.notify_all();
+}
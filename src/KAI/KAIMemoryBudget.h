@@ -0,0 +1,89 @@
+#ifndef KAIMEMORYBUDGET_H
+#define KAIMEMORYBUDGET_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+
+#include "Deadline.h"
+
+/**
+ * @brief Memory-budgeted admission control for concurrent images
+ * @note  The memory needed to process an image is estimated from its header before it is
+ *        decoded (width x height x 3 channels x expected copies: decoded image, task
+ *        inputs, overlay, ...). Images are admitted while the estimate fits the budget,
+ *        others wait in FIFO order, so as many images as the memory allows run in parallel
+ *        without the risk of over-committing.
+ *
+ *        KAIMemoryBudget budget(2048 * MB);
+ *        KAIMemoryBudget::Reservation reservation = budget.acquire(budget.estimateEncoded(data, size));
+ *        // decode + process (memory is given back when the reservation is destroyed)
+ *
+ * @note  An image larger than the whole budget is admitted when nothing else is in flight
+ *        (it would never fit otherwise).
+ */
+class KAIMemoryBudget {
+public:
+
+    // bytes reserved for one image (released on destruction)
+    class Reservation {
+    public:
+        Reservation() = default;
+        Reservation(Reservation&& other) noexcept {*this = std::move(other);}
+        Reservation& operator=(Reservation&& other) noexcept;
+        Reservation(const Reservation&) = delete;
+        Reservation& operator=(const Reservation&) = delete;
+        ~Reservation() {release();}
+
+        size_t bytes() const {return reservedBytes;}
+        explicit operator bool() const {return budget != nullptr;}
+
+        // give the memory back before destruction (e.g. once the image is released)
+        void release();
+
+    private:
+        friend class KAIMemoryBudget;
+        Reservation(KAIMemoryBudget* b, size_t n): budget(b), reservedBytes(n) {}
+
+        KAIMemoryBudget* budget = nullptr;
+        size_t reservedBytes = 0;
+    };
+
+    // copiesPerImage: decoded image size multiples held while an image is processed
+    explicit KAIMemoryBudget(size_t bytes, double copiesPerImage = 3.0);
+
+    size_t budget() const {return budgetBytes;}
+    size_t inUse() const;
+
+    // estimated memory to process a (decoded, BGR) image of the given size
+    size_t estimate(int width, int height) const;
+
+    // estimate from the header of an encoded image (jpg, png, bmp, tif)
+    // Note: images with an unknown header reserve the whole budget (processed alone)
+    size_t estimateEncoded(const uint8_t* data, size_t size) const;
+
+    // width/height from the header of an encoded image, without decoding it
+    static bool probeImageHeader(const uint8_t* data, size_t size, int& width, int& height);
+
+    // wait until <bytes> fit the budget
+    Reservation acquire(size_t bytes);
+
+    // wait until <bytes> fit the budget or the deadline expires (returns false)
+    bool acquire(size_t bytes, const Deadline& deadline, Reservation& reservation);
+
+private:
+    void release(size_t bytes);
+
+    const size_t budgetBytes;
+    const double copies;
+
+    mutable std::mutex mutex;
+    std::condition_variable released;
+    size_t usedBytes = 0;
+
+    // waiting requests (admitted in arrival order)
+    std::deque<const void*> waiting;
+};
+#endif // KAIMEMORYBUDGET_H
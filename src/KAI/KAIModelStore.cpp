@@ -0,0 +1,130 @@
+#include "KAIModelStore.h"
+#include "Logger.h"
+#include "MappedShapePredictor.h"
+
+#include "tensorflow/lite/model_builder.h"
+
+#include <dlib/image_processing.h>
+
+#include <climits>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+    // cache file name: <model file name>-<hash of the absolute model path>.kaisp
+    // (models with the same file name in different directories get their own cache)
+    std::string cacheFileName(const std::string& path)
+    {
+        char resolved[PATH_MAX];
+        const std::string absPath = (realpath(path.c_str(), resolved) != nullptr) ? std::string(resolved) : path;
+
+        // FNV-1a (stable across processes and builds, unlike std::hash)
+        uint64_t hash = 14695981039346656037ull;
+        for (unsigned char c : absPath) {
+            hash = (hash ^ c) * 1099511628211ull;
+        }
+        char hex[17];
+        std::snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(hash));
+
+        size_t slash = path.find_last_of('/');
+        const std::string fileName = (slash == std::string::npos) ? path : path.substr(slash + 1);
+        return fileName + "-" + hex + ".kaisp";
+    }
+}
+
+KAIModelStore& KAIModelStore::getInstance()
+{
+    static KAIModelStore instance;
+    return instance;
+}
+
+KAIModelStore::KAIModelStore()
+{
+    // default for processes without command line options (C API, Python)
+    const char* dir = std::getenv("KAI_MODEL_CACHE");
+    if (dir != nullptr) {
+        cacheDir = dir;
+    }
+}
+
+void KAIModelStore::setCacheDir(const std::string& dir)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    cacheDir = dir;
+}
+
+std::string KAIModelStore::getCacheDir()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return cacheDir;
+}
+
+std::shared_ptr<const tflite::FlatBufferModel> KAIModelStore::getTFLiteModel(const std::string& path)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (auto model = tfliteModels[path].lock()) {
+        return model;
+    }
+
+    std::shared_ptr<const tflite::FlatBufferModel> model = tflite::FlatBufferModel::BuildFromFile(path.c_str());
+    if (model == nullptr) {
+        Logger::getInstance().log(ERROR, "[KAI Model Store]-- Error: could not load " + path);
+        return nullptr;
+    }
+    tfliteModels[path] = model;
+
+    Logger::getInstance().log(INFO, "[KAI Model Store]-- loaded " + path);
+    return model;
+}
+
+std::shared_ptr<const dlib::shape_predictor> KAIModelStore::getShapePredictor(const std::string& path)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (auto predictor = shapePredictors[path].lock()) {
+        return predictor;
+    }
+
+    auto predictor = std::make_shared<dlib::shape_predictor>();
+    dlib::deserialize(path) >> *predictor;
+    shapePredictors[path] = predictor;
+
+    Logger::getInstance().log(INFO, "[KAI Model Store]-- loaded " + path);
+    return predictor;
+}
+
+std::shared_ptr<const MappedShapePredictor> KAIModelStore::getMappedShapePredictor(const std::string& path)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (cacheDir.empty()) {
+        return nullptr;
+    }
+
+    if (auto predictor = mappedShapePredictors[path].lock()) {
+        return predictor;
+    }
+
+    const std::string cachePath = cacheDir + "/" + cacheFileName(path);
+
+    Logger& logger = Logger::getInstance();
+    try {
+        // first process on the host (or model updated): convert once
+        if (!MappedShapePredictor::isCurrent(cachePath, path)) {
+            logger.log(INFO, "[KAI Model Store]-- building " + cachePath);
+            MappedShapePredictor::build(path, cachePath);
+        }
+
+        auto predictor = std::make_shared<const MappedShapePredictor>(cachePath);
+        mappedShapePredictors[path] = predictor;
+
+        logger.log(INFO, "[KAI Model Store]-- mapped " + cachePath);
+        return predictor;
+    }
+    catch (const std::exception& e) {
+        logger.log(ERROR, std::string(e.what()) + " (loading " + path + " per process)");
+        return nullptr;
+    }
+}
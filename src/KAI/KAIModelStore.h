@@ -0,0 +1,72 @@
+#ifndef KAIMODELSTORE_H
+#define KAIMODELSTORE_H
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace tflite {
+    class FlatBufferModel;
+}
+
+namespace dlib {
+    class shape_predictor;
+}
+
+class MappedShapePredictor;
+
+/**
+ * @brief Process-wide store of the loaded models
+ * @note  Parallel workers (batch inference instances, C API instances) each build their
+ *        own task pipeline; the store loads the models that can be shared once:
+ *        - TFLite: one immutable FlatBufferModel shared by the interpreters of all
+ *          workers (each interpreter only owns its tensors/activations)
+ *        - dlib: one shape predictor shared by all workers (inference is const)
+ *
+ *        Models are kept while a task refers to them (released with the last one).
+ *        cv::dnn models are not in the store: cv::dnn::Net copies the weights into its
+ *        layers and cannot run forward() concurrently, so each worker loads its own
+ *        network from the model file (one copy of the weights per worker).
+ *
+ *        Cross-process sharing (worker processes on one host): with a cache directory
+ *        (setCacheDir, or the KAI_MODEL_CACHE environment variable), dlib models are
+ *        converted once to a pre-parsed file that all processes memory-map read-only
+ *        (MappedShapePredictor). TFLite models are always memory-mapped from the model
+ *        file (FlatBufferModel::BuildFromFile), so they are shared without a cache.
+ *
+ *        auto model = KAIModelStore::getInstance().getTFLiteModel(modelPath);
+ *
+ * @note  Thread safe.
+ */
+class KAIModelStore {
+public:
+    static KAIModelStore& getInstance();
+
+    // shared TFLite model (nullptr if it cannot be loaded)
+    std::shared_ptr<const tflite::FlatBufferModel> getTFLiteModel(const std::string& path);
+
+    // shared dlib shape predictor (throws dlib::serialization_error if it cannot be loaded)
+    std::shared_ptr<const dlib::shape_predictor> getShapePredictor(const std::string& path);
+
+    /**
+     * @brief memory-mapped dlib shape predictor (built into the cache directory if needed)
+     * @return nullptr without a cache directory or if the model cannot be converted
+     *         (use getShapePredictor then)
+     */
+    std::shared_ptr<const MappedShapePredictor> getMappedShapePredictor(const std::string& path);
+
+    // directory of the pre-parsed model files ("": no cache)
+    void setCacheDir(const std::string& dir);
+    std::string getCacheDir();
+
+private:
+    KAIModelStore();
+
+    std::mutex mutex;
+    std::string cacheDir;
+    std::map<std::string, std::weak_ptr<const tflite::FlatBufferModel>> tfliteModels;
+    std::map<std::string, std::weak_ptr<const dlib::shape_predictor>> shapePredictors;
+    std::map<std::string, std::weak_ptr<const MappedShapePredictor>> mappedShapePredictors;
+};
+#endif // KAIMODELSTORE_H
@@ -0,0 +1,196 @@
+#include "KAIPriorityScheduler.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+KAIPriority parsePriority(const std::string& name)
+{
+    return (name == "bulk") ? KAIPriority::Bulk : KAIPriority::Interactive;
+}
+
+///
+// KAIWeightedPicker
+///
+
+KAIWeightedPicker::KAIWeightedPicker(int interactiveWeight, int bulkWeight)
+    : weights{std::max(1, interactiveWeight), std::max(1, bulkWeight)}
+{
+}
+
+KAIPriority KAIWeightedPicker::next(bool interactiveWaiting, bool bulkWaiting)
+{
+    // a class waiting alone does not build up credit
+    if (!bulkWaiting) {
+        return KAIPriority::Interactive;
+    }
+    if (!interactiveWaiting) {
+        return KAIPriority::Bulk;
+    }
+
+    // smooth weighted round-robin: every class earns its weight, the richest one
+    // gets the turn and pays the total weight
+    credits[0] += weights[0];
+    credits[1] += weights[1];
+    const int turn = (credits[0] >= credits[1]) ? 0 : 1;
+    credits[turn] -= weights[0] + weights[1];
+    return static_cast<KAIPriority>(turn);
+}
+
+///
+// KAIPriorityScheduler::Lease
+///
+
+KAIPriorityScheduler::Lease::Lease(KAIPriorityScheduler* s, size_t slot, KAIPriority priority)
+    : scheduler(s), slot(slot), priority(priority)
+{
+}
+
+KAIPriorityScheduler::Lease::Lease(Lease&& other) noexcept
+    : scheduler(other.scheduler), slot(other.slot), priority(other.priority)
+{
+    other.scheduler = nullptr;
+}
+
+KAIPriorityScheduler::Lease::~Lease()
+{
+    if (scheduler != nullptr) {
+        scheduler->release(slot);
+    }
+}
+
+void KAIPriorityScheduler::Lease::yieldPoint()
+{
+    if (scheduler != nullptr && priority == KAIPriority::Bulk) {
+        scheduler->yield(slot);
+    }
+}
+
+///
+// KAIPriorityScheduler
+///
+
+KAIPriorityScheduler::KAIPriorityScheduler(size_t slots, int interactiveWeight, int bulkWeight)
+    : busy(slots, false), picker(interactiveWeight, bulkWeight)
+{
+    if (slots == 0) {
+        throw std::runtime_error("[KAI Scheduler]-- Error: at least one slot is required");
+    }
+}
+
+KAIPriorityScheduler::Lease KAIPriorityScheduler::acquire(KAIPriority priority)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+
+    Waiter waiter;
+    queues[static_cast<int>(priority)].push_back(&waiter);
+    grantSlots();
+    slotGranted.wait(lock, [&waiter] {return waiter.granted;});
+
+    return Lease(this, waiter.slot, priority);
+}
+
+size_t KAIPriorityScheduler::getWaiting(KAIPriority priority)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return queues[static_cast<int>(priority)].size();
+}
+
+void KAIPriorityScheduler::release(size_t slot)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    busy[slot] = false;
+    grantSlots();
+}
+
+void KAIPriorityScheduler::yield(size_t slot)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+
+    std::deque<Waiter*>& interactive = queues[static_cast<int>(KAIPriority::Interactive)];
+    if (interactive.empty()) {
+        return;
+    }
+
+    // hand the slot to the oldest Interactive request
+    Waiter* next = interactive.front();
+    interactive.pop_front();
+    next->slot = slot;
+    next->granted = true;
+
+    // resume first among Bulk work, on the same slot (the pipeline holds this image's progress)
+    Waiter waiter;
+    waiter.resuming = true;
+    waiter.slot = slot;
+    queues[static_cast<int>(KAIPriority::Bulk)].push_front(&waiter);
+
+    slotGranted.notify_all();
+    slotGranted.wait(lock, [&waiter] {return waiter.granted;});
+}
+
+void KAIPriorityScheduler::grantSlots()
+{
+    bool granted = false;
+    while (true) {
+        size_t slots[2] = {0, 0};
+        Waiter* candidates[2] = {findEligible(queues[0], slots[0]), findEligible(queues[1], slots[1])};
+        if (candidates[0] == nullptr && candidates[1] == nullptr) {
+            break;
+        }
+
+        const int turn = static_cast<int>(picker.next(candidates[0] != nullptr, candidates[1] != nullptr));
+        Waiter* waiter = candidates[turn];
+        std::deque<Waiter*>& queue = queues[turn];
+        queue.erase(std::find(queue.begin(), queue.end(), waiter));
+
+        waiter->slot = slots[turn];
+        waiter->granted = true;
+        busy[waiter->slot] = true;
+        granted = true;
+    }
+
+    if (granted) {
+        slotGranted.notify_all();
+    }
+}
+
+KAIPriorityScheduler::Waiter* KAIPriorityScheduler::findEligible(const std::deque<Waiter*>& queue,
+                                                                 size_t& slot) const
+{
+    for (Waiter* waiter : queue) {
+        if (waiter->resuming) {
+            // preempted work only runs on its own slot
+            if (!busy[waiter->slot]) {
+                slot = waiter->slot;
+                return waiter;
+            }
+        }
+        else if (findFreeSlot(slot)) {
+            return waiter;
+        }
+    }
+    return nullptr;
+}
+
+bool KAIPriorityScheduler::findFreeSlot(size_t& slot) const
+{
+    bool found = false;
+    for (size_t i = 0; i < busy.size(); ++i) {
+        if (busy[i]) {
+            continue;
+        }
+
+        bool reserved = false;
+        for (const Waiter* waiter : queues[static_cast<int>(KAIPriority::Bulk)]) {
+            reserved = reserved || (waiter->resuming && waiter->slot == i);
+        }
+        if (!reserved) {
+            slot = i;
+            return true;
+        }
+        if (!found) {
+            slot = i;
+            found = true;
+        }
+    }
+    return found;
+}
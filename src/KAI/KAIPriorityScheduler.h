@@ -0,0 +1,114 @@
+#ifndef KAIPRIORITYSCHEDULER_H
+#define KAIPRIORITYSCHEDULER_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// traffic classes: Interactive (a user waits for the answer), Bulk (backfill, reprocessing)
+enum class KAIPriority {
+    Interactive = 0,
+    Bulk = 1
+};
+
+// "bulk" -> Bulk, anything else -> Interactive
+KAIPriority parsePriority(const std::string& name);
+
+/**
+ * @brief Weighted round-robin between the two traffic classes (smooth WRR)
+ * @note  While both classes wait, Interactive gets <interactiveWeight> turns for every
+ *        <bulkWeight> turns of Bulk (interleaved, e.g. I I B I I for 4:1);
+ *        a class waiting alone gets every turn. Not thread safe (callers hold a lock).
+ */
+class KAIWeightedPicker {
+public:
+    explicit KAIWeightedPicker(int interactiveWeight = 4, int bulkWeight = 1);
+
+    // class of the next turn (at least one class must be waiting)
+    KAIPriority next(bool interactiveWaiting, bool bulkWaiting);
+
+private:
+    int weights[2];
+    int credits[2] = {0, 0};
+};
+
+/**
+ * @brief Grants pipeline slots (task managers) to Interactive and Bulk requests
+ * @note  - separate FIFO queues per class, weighted round-robin between them
+ *          (Bulk is never starved by a steady stream of Interactive requests)
+ *        - preemption at task boundaries: a Bulk lease calls yieldPoint() between
+ *          KAITask::run calls; if Interactive work is waiting, it hands over its slot and
+ *          resumes on the same slot (its pipeline is in the middle of the image) afterwards.
+ *          A running task is never interrupted.
+ *
+ *        KAIPriorityScheduler scheduler(instances.size());
+ *        KAIPriorityScheduler::Lease lease = scheduler.acquire(KAIPriority::Bulk);
+ *        img.setTaskBoundaryHook([&lease] {lease.yieldPoint();});
+ *        instances[lease.getSlot()]->runTasks(img);
+ *
+ * @note  Thread safe. Leases must be released (destroyed) by the thread that uses them.
+ */
+class KAIPriorityScheduler {
+public:
+    class Lease {
+    public:
+        Lease(Lease&& other) noexcept;
+        ~Lease();
+
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+        Lease& operator=(Lease&&) = delete;
+
+        size_t getSlot() const {return slot;}
+        KAIPriority getPriority() const {return priority;}
+
+        // task boundary: Bulk work lets waiting Interactive work run first (no-op otherwise)
+        void yieldPoint();
+
+    private:
+        friend class KAIPriorityScheduler;
+        Lease(KAIPriorityScheduler* s, size_t slot, KAIPriority priority);
+
+        KAIPriorityScheduler* scheduler;
+        size_t slot;
+        KAIPriority priority;
+    };
+
+    // <slots>: number of images processed in parallel (e.g. task manager instances)
+    explicit KAIPriorityScheduler(size_t slots = 1, int interactiveWeight = 4, int bulkWeight = 1);
+
+    // wait for a slot
+    Lease acquire(KAIPriority priority);
+
+    // requests waiting for a slot (incl. preempted Bulk work)
+    size_t getWaiting(KAIPriority priority);
+
+private:
+    struct Waiter {
+        bool resuming = false;   // preempted Bulk work: needs its own slot back
+        size_t slot = 0;         // requested (resuming) or granted slot
+        bool granted = false;
+    };
+
+    // grant free slots to waiting requests (mutex held)
+    void grantSlots();
+
+    // first waiter of <queue> that can take a free slot (nullptr if none), slot in <slot>
+    Waiter* findEligible(const std::deque<Waiter*>& queue, size_t& slot) const;
+
+    // free slot, preferably one no preempted work waits for (false if none)
+    bool findFreeSlot(size_t& slot) const;
+
+    void release(size_t slot);
+    void yield(size_t slot);
+
+    std::mutex mutex;
+    std::condition_variable slotGranted;
+    std::vector<bool> busy;
+    std::deque<Waiter*> queues[2];   // by KAIPriority
+    KAIWeightedPicker picker;
+};
+#endif // KAIPRIORITYSCHEDULER_H
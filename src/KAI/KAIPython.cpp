@@ -0,0 +1,161 @@
+// Python bindings for the KAI pipeline
+//
+//  import kai
+//  pipeline = kai.Pipeline("MLConfig_FD-FF.json")
+//  results = pipeline.run(image)   # image: HxWx3 uint8 numpy array (BGR, e.g. from cv2.imread)
+//
+// The numpy buffer is wrapped as cv::Mat (no copy) and the GIL is released during inference.
+
+#include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+#include <pybind11/stl.h>
+
+#include <opencv2/imgproc.hpp>
+
+#include <memory>
+#include <mutex>
+
+#include "KAITaskManager.h"
+
+namespace py = pybind11;
+
+/**
+ * @brief Resident KAI pipeline (models are loaded once)
+ * @note  tasks own their inference state, so one image is processed at a time per pipeline;
+ *        other Python threads keep running while an image is processed (GIL released).
+ */
+class PyKAIPipeline {
+public:
+    explicit PyKAIPipeline(const std::string& configPath) {
+        manager.loadMLConfigs(configPath);
+    }
+
+    py::dict run(py::array_t<uint8_t> image, int deadlineMs, const std::string& color,
+                 const std::string& name, const std::vector<std::string>& tasks) {
+
+        // HxWx3 with interleaved pixels (rows may be padded, e.g. a crop of a larger array)
+        if (image.ndim() != 3 || image.shape(2) != 3) {
+            throw std::invalid_argument("kai.Pipeline.run: expected an HxWx3 uint8 array.");
+        }
+        if (image.strides(2) != 1 || image.strides(1) != 3 || image.strides(0) < image.shape(1) * 3) {
+            throw std::invalid_argument("kai.Pipeline.run: array rows must be contiguous "
+                                        "(use numpy.ascontiguousarray).");
+        }
+        if (color != "bgr" && color != "rgb") {
+            throw std::invalid_argument("kai.Pipeline.run: color must be 'bgr' or 'rgb'.");
+        }
+        for (const auto& taskName : tasks) {
+            if (!manager.hasTask(taskName)) {
+                throw std::invalid_argument("kai.Pipeline.run: unknown task '" + taskName + "'.");
+            }
+        }
+
+        // wrap the numpy buffer (no copy)
+        cv::Mat imgMat(static_cast<int>(image.shape(0)), static_cast<int>(image.shape(1)), CV_8UC3,
+                       const_cast<uint8_t*>(image.data()), static_cast<size_t>(image.strides(0)));
+
+        std::unique_ptr<Image> img;
+        {
+            py::gil_scoped_release release;
+
+            // the pipeline works on BGR images
+            if (color == "rgb") {
+                cv::Mat bgrMat;
+                cv::cvtColor(imgMat, bgrMat, cv::COLOR_RGB2BGR);
+                imgMat = bgrMat;
+            }
+
+            img = std::make_unique<Image>(imgMat, name);
+            if (deadlineMs > 0) {
+                img->setDeadline(Deadline(std::chrono::milliseconds(deadlineMs)));
+            }
+            img->setRequestedTasks(tasks);
+
+            std::lock_guard<std::mutex> lock(pipelineMutex);
+            manager.runTasks(*img);
+        }
+
+        return toPython(*img);
+    }
+
+private:
+    KAITaskManager manager;
+    std::mutex pipelineMutex;
+
+    // convert results to Python objects (GIL held)
+    static py::dict toPython(Image& img) {
+        py::list faces;
+
+        auto vFFeatures = img.getFacialFeatures();
+        if (vFFeatures.empty()) {
+            // face detection only
+            for (const auto& faceBbox : img.getImage_faceBboxes()) {
+                const cv::Rect& box = faceBbox.first;
+
+                py::dict face;
+                face["bbox"] = py::make_tuple(box.x, box.y, box.width, box.height);
+                face["confidence"] = faceBbox.second;
+                faces.append(face);
+            }
+        }
+
+        for (const auto& fFeatures : vFFeatures) {
+            const cv::Rect box = fFeatures.getFaceBbox();
+
+            py::dict face;
+            face["bbox"] = py::make_tuple(box.x, box.y, box.width, box.height);
+            face["confidence"] = fFeatures.getFaceConfidence();
+
+            // feature points as an Nx2 int32 array
+            LandmarkView points = fFeatures.getFacialFeatures();
+            py::array_t<int32_t> landmarks({static_cast<py::ssize_t>(points.size()), static_cast<py::ssize_t>(2)});
+            auto out = landmarks.mutable_unchecked<2>();
+            for (size_t i = 0; i < points.size(); ++i) {
+                out(i, 0) = static_cast<int32_t>(points.x()[i]);
+                out(i, 1) = static_cast<int32_t>(points.y()[i]);
+            }
+            face["landmarks"] = landmarks;
+
+            // auxiliary data (only if computed)
+            if (fFeatures.hasAuxData(AuxData::eHeadPose)) {
+                const HeadPose& headPose = fFeatures.getAuxData<HeadPose>();
+                py::dict pose;
+                pose["roll"] = headPose.roll;
+                pose["yaw"] = headPose.yaw;
+                pose["pitch"] = headPose.pitch;
+                face["head_pose"] = pose;
+            }
+            if (fFeatures.hasAuxData(AuxData::eMouthOpen)) {
+                face["mouth_open"] = fFeatures.isMouthOpen();
+            }
+            if (fFeatures.hasAuxData(AuxData::eSmile)) {
+                face["smile"] = fFeatures.isSmileDetected();
+            }
+            if (fFeatures.hasAuxData(AuxData::eEyeglasses)) {
+                face["eyeglasses"] = fFeatures.isEyeglassesDetected();
+            }
+
+            faces.append(face);
+        }
+
+        py::dict results;
+        results["faces"] = faces;
+        results["partial"] = img.isPartial();
+        results["partial_tasks"] = img.getPartialTasks();
+        return results;
+    }
+};
+
+PYBIND11_MODULE(kai, m) {
+    m.doc() = "KAI (Kodak AI) face analysis pipeline";
+
+    py::class_<PyKAIPipeline>(m, "Pipeline")
+        .def(py::init<const std::string&>(), py::arg("config_path"),
+             "Load the tasks and models of an MLConfig JSON file.")
+        .def("run", &PyKAIPipeline::run,
+             py::arg("image"), py::arg("deadline_ms") = 0, py::arg("color") = "bgr",
+             py::arg("name") = "numpy", py::arg("tasks") = std::vector<std::string>(),
+             "Process an HxWx3 uint8 image (no copy for BGR input) and return the results.\n"
+             "tasks: outputs to compute (e.g. ['FaceDetection', 'Smile']; default: all tasks).\n"
+             "The array must not be modified while it is processed.");
+}
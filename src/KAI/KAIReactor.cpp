@@ -0,0 +1,546 @@
+#include "KAIReactor.h"
+#include "Logger.h"
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+
+#include <algorithm>
+#include <cctype>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+    // traffic class of a raw request ("priority=bulk" query on the request line)
+    KAIPriority requestPriority(const std::string& request) {
+        const std::string requestLine = request.substr(0, request.find("\r\n"));
+        const size_t query = requestLine.find('?');
+        if (query == std::string::npos) {
+            return KAIPriority::Interactive;
+        }
+
+        size_t pos = requestLine.find("priority=bulk", query);
+        while (pos != std::string::npos) {
+            const char before = requestLine[pos - 1];
+            const size_t end = pos + std::string("priority=bulk").size();
+            if ((before == '?' || before == '&') &&
+                (end == requestLine.size() || requestLine[end] == '&' || requestLine[end] == ' ')) {
+                return KAIPriority::Bulk;
+            }
+            pos = requestLine.find("priority=bulk", end);
+        }
+        return KAIPriority::Interactive;
+    }
+}
+
+KAIReactor::KAIReactor(KAIHttpHandler& requestHandler, int ioThreads, int computeThreads)
+    : handler(requestHandler),
+      numIOThreads(std::max(1, ioThreads)),
+      numComputeThreads(std::max(1, computeThreads))
+{
+}
+
+KAIReactor::~KAIReactor()
+{
+    stop();
+    cleanup();
+}
+
+void KAIReactor::start()
+{
+    Logger& logger = Logger::getInstance();
+
+    ///
+    // listening socket
+    ///
+    listenFd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listenFd < 0) {
+        throw std::runtime_error("KAI Reactor -- Error: could not create socket (" + std::string(strerror(errno)) + ")");
+    }
+
+    int reuse = 1;
+    setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(static_cast<uint16_t>(listeningPort));
+
+    if (bind(listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+        listen(listenFd, SOMAXCONN) < 0) {
+        std::string err = strerror(errno);
+        cleanup();
+        throw std::runtime_error("KAI Reactor -- Error: could not listen on port " +
+                                 std::to_string(listeningPort) + " (" + err + ")");
+    }
+
+    ///
+    // event loop setup
+    ///
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    stopFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epollFd < 0 || stopFd < 0) {
+        cleanup();
+        throw std::runtime_error("KAI Reactor -- Error: could not create epoll instance.");
+    }
+
+    // stop event is level-triggered (never consumed), so it wakes every I/O thread
+    epoll_event ev;
+    ev.events = EPOLLIN;
+    ev.data.fd = stopFd;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, stopFd, &ev);
+
+    // one-shot: a single I/O thread accepts at a time
+    ev.events = EPOLLIN | EPOLLONESHOT;
+    ev.data.fd = listenFd;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &ev);
+
+    running = true;
+    computeStop = false;
+
+    for (int i = 0; i < numComputeThreads; ++i) {
+        computeWorkers.emplace_back(&KAIReactor::computeLoop, this);
+    }
+
+    std::vector<std::thread> ioWorkers;
+    for (int i = 1; i < numIOThreads; ++i) {
+        ioWorkers.emplace_back(&KAIReactor::ioLoop, this);
+    }
+
+    logger.log(INFO, "[KAI Reactor]-- Listening on port " + std::to_string(listeningPort) +
+                     " (" + std::to_string(numIOThreads) + " I/O thread(s), " +
+                     std::to_string(numComputeThreads) + " compute thread(s))");
+
+    // calling thread is the first I/O thread
+    ioLoop();
+
+    for (auto& worker : ioWorkers) {
+        worker.join();
+    }
+
+    // finish queued requests, then release sockets
+    {
+        std::lock_guard<std::mutex> lock(computeMutex);
+        computeStop = true;
+    }
+    computeCondition.notify_all();
+    for (auto& worker : computeWorkers) {
+        worker.join();
+    }
+    computeWorkers.clear();
+
+    cleanup();
+}
+
+void KAIReactor::stop()
+{
+    running = false;
+
+    if (stopFd >= 0) {
+        uint64_t one = 1;
+        ssize_t ret = write(stopFd, &one, sizeof(one));
+        (void)ret;
+    }
+}
+
+void KAIReactor::ioLoop()
+{
+    const int maxEvents = 64;
+    epoll_event events[maxEvents];
+
+    while (running) {
+        int n = epoll_wait(epollFd, events, maxEvents, -1);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            Logger::getInstance().log(ERROR, "[KAI Reactor]-- epoll_wait failed: " + std::string(strerror(errno)));
+            return;
+        }
+
+        for (int i = 0; i < n; ++i) {
+            int fd = events[i].data.fd;
+
+            if (fd == stopFd) {
+                return;
+            }
+
+            if (fd == listenFd) {
+                acceptConnections();
+                rearm(listenFd, EPOLLIN);
+                continue;
+            }
+
+            std::shared_ptr<Connection> conn = findConnection(fd);
+            if (!conn) {
+                continue;
+            }
+
+            if (conn->writing) {
+                handleWrite(conn);
+            }
+            else {
+                handleRead(conn);
+            }
+        }
+    }
+}
+
+void KAIReactor::computeLoop()
+{
+    while (true) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(computeMutex);
+            computeCondition.wait(lock, [this] {
+                return computeStop || !computeQueues[0].empty() || !computeQueues[1].empty();
+            });
+
+            if (computeQueues[0].empty() && computeQueues[1].empty()) {
+                return; // stopped and drained
+            }
+
+            std::deque<std::function<void()>>& queue =
+                computeQueues[static_cast<int>(computePicker.next(!computeQueues[0].empty(),
+                                                                  !computeQueues[1].empty()))];
+            job = std::move(queue.front());
+            queue.pop_front();
+        }
+
+        job();
+    }
+}
+
+void KAIReactor::acceptConnections()
+{
+    while (true) {
+        sockaddr_in addr;
+        socklen_t addrLen = sizeof(addr);
+        int fd = accept4(listenFd, reinterpret_cast<sockaddr*>(&addr), &addrLen,
+                         SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            // EAGAIN: no more pending connections
+            return;
+        }
+
+        auto conn = std::make_shared<Connection>();
+        conn->fd = fd;
+        char ip[INET_ADDRSTRLEN] = {0};
+        inet_ntop(AF_INET, &addr.sin_addr, ip, sizeof(ip));
+        conn->foreignIp = ip;
+        conn->foreignPort = ntohs(addr.sin_port);
+
+        {
+            std::lock_guard<std::mutex> lock(connectionsMutex);
+            if (connections.size() >= maxConnections) {
+                close(fd);
+                continue;
+            }
+            connections[fd] = conn;
+        }
+
+        int noDelay = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+
+        epoll_event ev;
+        ev.events = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT;
+        ev.data.fd = fd;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev);
+    }
+}
+
+void KAIReactor::handleRead(const std::shared_ptr<Connection>& conn)
+{
+    char buffer[16 * 1024];
+    bool peerClosed = false;
+
+    while (true) {
+        ssize_t r = recv(conn->fd, buffer, sizeof(buffer), 0);
+        if (r > 0) {
+            conn->inBuffer.append(buffer, static_cast<size_t>(r));
+        }
+        else if (r == 0) {
+            peerClosed = true;
+            break;
+        }
+        else if (errno == EINTR) {
+            continue;
+        }
+        else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            break;
+        }
+        else {
+            closeConnection(conn);
+            return;
+        }
+    }
+
+    std::string request;
+    try {
+        if (!extractRequest(*conn, request)) {
+            if (peerClosed) {
+                closeConnection(conn);
+            }
+            else {
+                rearm(conn->fd, EPOLLIN | EPOLLRDHUP);
+            }
+            return;
+        }
+    }
+    catch (const dlib::http_parse_error& e) {
+        sendError(conn, e);
+        return;
+    }
+
+    // peer half-closed after sending its request: answer, then close
+    conn->closeAfterWrite = peerClosed;
+    dispatch(conn, std::move(request));
+}
+
+void KAIReactor::handleWrite(const std::shared_ptr<Connection>& conn)
+{
+    while (conn->outOffset < conn->outBuffer.size()) {
+        ssize_t w = send(conn->fd, conn->outBuffer.data() + conn->outOffset,
+                         conn->outBuffer.size() - conn->outOffset, MSG_NOSIGNAL);
+        if (w > 0) {
+            conn->outOffset += static_cast<size_t>(w);
+        }
+        else if (w < 0 && errno == EINTR) {
+            continue;
+        }
+        else if (w < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            // socket buffer full: resume when writable
+            rearm(conn->fd, EPOLLOUT | EPOLLRDHUP);
+            return;
+        }
+        else {
+            closeConnection(conn);
+            return;
+        }
+    }
+
+    // response sent
+    conn->outBuffer.clear();
+    conn->outOffset = 0;
+    conn->writing = false;
+
+    if (!conn->keepAlive || conn->closeAfterWrite) {
+        closeConnection(conn);
+        return;
+    }
+
+    // next (pipelined) request may already be buffered
+    std::string request;
+    try {
+        if (extractRequest(*conn, request)) {
+            dispatch(conn, std::move(request));
+            return;
+        }
+    }
+    catch (const dlib::http_parse_error& e) {
+        sendError(conn, e);
+        return;
+    }
+
+    // wait for the next request (idle keep-alive connection holds no thread)
+    rearm(conn->fd, EPOLLIN | EPOLLRDHUP);
+}
+
+bool KAIReactor::extractRequest(Connection& conn, std::string& request)
+{
+    size_t headerEnd = conn.inBuffer.find("\r\n\r\n");
+    if (headerEnd == std::string::npos) {
+        if (conn.inBuffer.size() > maxHeaderLength) {
+            throw dlib::http_parse_error("Request headers too large", 431);
+        }
+        return false;
+    }
+    headerEnd += 4;
+
+    // body length from the headers (dlib parses the request itself later)
+    unsigned long contentLength = 0;
+    std::istringstream headers(conn.inBuffer.substr(0, headerEnd));
+    std::string line;
+    std::getline(headers, line); // request line
+    while (std::getline(headers, line)) {
+        size_t colon = line.find(':');
+        if (colon == std::string::npos) {
+            continue;
+        }
+
+        std::string name = line.substr(0, colon);
+        std::transform(name.begin(), name.end(), name.begin(),
+                       [](unsigned char c) {return static_cast<char>(std::tolower(c));});
+        std::string value = line.substr(colon + 1);
+
+        if (name == "content-length") {
+            try {
+                contentLength = std::stoul(value);
+            }
+            catch (const std::exception&) {
+                throw dlib::http_parse_error("Invalid Content-Length", 400);
+            }
+        }
+        else if (name == "transfer-encoding") {
+            throw dlib::http_parse_error("Length Required", 411);
+        }
+    }
+
+    if (contentLength > maxContentLength) {
+        throw dlib::http_parse_error("Content-Length of post back is too large", 413);
+    }
+
+    if (conn.inBuffer.size() < headerEnd + contentLength) {
+        return false; // body not complete yet
+    }
+
+    request = conn.inBuffer.substr(0, headerEnd + contentLength);
+    conn.inBuffer.erase(0, headerEnd + contentLength);
+    return true;
+}
+
+void KAIReactor::dispatch(const std::shared_ptr<Connection>& conn, std::string request)
+{
+    {
+        const KAIPriority priority = requestPriority(request);
+        std::lock_guard<std::mutex> lock(computeMutex);
+        computeQueues[static_cast<int>(priority)].emplace_back([this, conn, request = std::move(request)]() {
+            processRequest(conn, request);
+        });
+    }
+    computeCondition.notify_one();
+}
+
+void KAIReactor::processRequest(const std::shared_ptr<Connection>& conn, const std::string& request)
+{
+    dlib::incoming_things incoming(conn->foreignIp, "", conn->foreignPort,
+                                   static_cast<unsigned short>(listeningPort));
+    dlib::outgoing_things outgoing;
+    std::ostringstream out;
+    bool keepAlive = false;
+
+    try {
+        std::istringstream in(request);
+        dlib::parse_http_request(in, incoming, maxContentLength);
+        dlib::read_body(in, incoming);
+
+        // HTTP/1.1 keeps the connection by default, HTTP/1.0 only on request
+        std::string connection = incoming.headers["Connection"];
+        std::transform(connection.begin(), connection.end(), connection.begin(),
+                       [](unsigned char c) {return static_cast<char>(std::tolower(c));});
+        // Note: dlib keeps the trailing '\r' of the request line in incoming.protocol
+        if (incoming.protocol.compare(0, 8, "HTTP/1.1") == 0) {
+            keepAlive = (connection != "close");
+        }
+        else {
+            keepAlive = (connection == "keep-alive");
+        }
+
+        const std::string result = handler.handleRequest(incoming, outgoing);
+        outgoing.headers["Connection"] = keepAlive ? "keep-alive" : "close";
+        dlib::write_http_response(out, outgoing, result);
+    }
+    catch (const dlib::http_parse_error& e) {
+        keepAlive = false;
+        out.str("");
+        dlib::write_http_response(out, e);
+    }
+    catch (const std::exception& e) {
+        keepAlive = false;
+        out.str("");
+        dlib::write_http_response(out, e);
+    }
+
+    conn->outBuffer = out.str();
+    conn->outOffset = 0;
+    conn->writing = true;
+    conn->keepAlive = keepAlive;
+
+    // this worker still owns the connection: try to send right away
+    handleWrite(conn);
+}
+
+void KAIReactor::sendError(const std::shared_ptr<Connection>& conn, const std::exception& e)
+{
+    std::ostringstream out;
+    const dlib::http_parse_error* parseError = dynamic_cast<const dlib::http_parse_error*>(&e);
+    if (parseError != nullptr) {
+        dlib::write_http_response(out, *parseError);
+    }
+    else {
+        dlib::write_http_response(out, e);
+    }
+
+    conn->inBuffer.clear();
+    conn->outBuffer = out.str();
+    conn->outOffset = 0;
+    conn->writing = true;
+    conn->keepAlive = false;
+
+    handleWrite(conn);
+}
+
+void KAIReactor::rearm(int fd, uint32_t events)
+{
+    epoll_event ev;
+    ev.events = events | EPOLLONESHOT;
+    ev.data.fd = fd;
+    epoll_ctl(epollFd, EPOLL_CTL_MOD, fd, &ev);
+}
+
+void KAIReactor::closeConnection(const std::shared_ptr<Connection>& conn)
+{
+    {
+        std::lock_guard<std::mutex> lock(connectionsMutex);
+        connections.erase(conn->fd);
+    }
+
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, conn->fd, nullptr);
+    close(conn->fd);
+    conn->fd = -1;
+}
+
+std::shared_ptr<KAIReactor::Connection> KAIReactor::findConnection(int fd)
+{
+    std::lock_guard<std::mutex> lock(connectionsMutex);
+    auto it = connections.find(fd);
+    if (it == connections.end()) {
+        return nullptr;
+    }
+    return it->second;
+}
+
+void KAIReactor::cleanup()
+{
+    {
+        std::lock_guard<std::mutex> lock(connectionsMutex);
+        for (auto& entry : connections) {
+            close(entry.first);
+            entry.second->fd = -1;
+        }
+        connections.clear();
+    }
+
+    if (listenFd >= 0) {
+        close(listenFd);
+        listenFd = -1;
+    }
+    if (epollFd >= 0) {
+        close(epollFd);
+        epollFd = -1;
+    }
+    if (stopFd >= 0) {
+        close(stopFd);
+        stopFd = -1;
+    }
+}
@@ -0,0 +1,133 @@
+#ifndef KAIREACTOR_H
+#define KAIREACTOR_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "KAIHttpHandler.h"
+#include "KAIPriorityScheduler.h"
+
+/**
+ * @brief Event-driven (epoll) HTTP front end for the KAI endpoint
+ * @note  A few I/O threads multiplex all sockets (accept, read, write) and hand complete
+ *        requests to a separate compute pool, so idle keep-alive connections cost a socket
+ *        and a buffer instead of a thread (dlib::server spawns a thread per connection).
+ *        Requests are parsed and answered with dlib's HTTP helpers (parse_http_request,
+ *        write_http_response), so both front ends behave the same.
+ *        Queued requests are picked per traffic class ("priority=bulk" query, see
+ *        KAIHttpHandler) with weighted round-robin, so interactive requests do not wait
+ *        behind a backlog of bulk requests.
+ * @note  Linux only (epoll).
+ */
+class KAIReactor {
+public:
+
+    KAIReactor(KAIHttpHandler& requestHandler, int ioThreads = 1, int computeThreads = 1);
+    ~KAIReactor();
+
+    KAIReactor(const KAIReactor&) = delete;
+    KAIReactor& operator=(const KAIReactor&) = delete;
+
+    void setListeningPort(int port) {listeningPort = port;}
+
+    // max. allowed request body size (413 above it)
+    void setMaxContentLength(unsigned long maxLength) {maxContentLength = maxLength;}
+
+    // max. number of open connections (new connections are refused above it)
+    void setMaxConnections(size_t maxConns) {maxConnections = maxConns;}
+
+    // listen and serve; blocks until stop() is called
+    void start();
+
+    // stop serving (can be called from any thread)
+    void stop();
+
+private:
+
+    struct Connection {
+        int fd = -1;
+        std::string foreignIp;
+        unsigned short foreignPort = 0;
+
+        std::string inBuffer;   // received bytes (may hold the start of the next request)
+        std::string outBuffer;  // response being sent
+        size_t outOffset = 0;
+
+        bool writing = false;   // response pending (waiting for EPOLLOUT)
+        bool keepAlive = false; // keep connection open after the response
+        bool closeAfterWrite = false;
+    };
+
+    KAIHttpHandler& handler;
+
+    int numIOThreads;
+    int numComputeThreads;
+
+    int listeningPort = 80;
+    unsigned long maxContentLength = 10 * 1024 * 1024; // same default as dlib::server_http
+    size_t maxConnections = 10000;
+
+    // max. size of the request line + headers
+    static const size_t maxHeaderLength = 64 * 1024;
+
+    int listenFd = -1;
+    int epollFd = -1;
+    int stopFd = -1;   // eventfd, wakes all I/O threads on stop()
+
+    std::atomic<bool> running{false};
+
+    // open connections (by socket)
+    // Note: with EPOLLONESHOT a connection is owned by a single thread at a time
+    //       (an I/O thread or a compute worker) until it is re-armed
+    std::map<int, std::shared_ptr<Connection>> connections;
+    std::mutex connectionsMutex;
+
+    ///
+    // compute pool
+    ///
+    std::deque<std::function<void()>> computeQueues[2];   // by KAIPriority
+    KAIWeightedPicker computePicker;
+    std::mutex computeMutex;
+    std::condition_variable computeCondition;
+    std::vector<std::thread> computeWorkers;
+    bool computeStop = false;
+
+    ///
+    // helper functions
+    ///
+
+    void ioLoop();
+    void computeLoop();
+
+    void acceptConnections();
+    void handleRead(const std::shared_ptr<Connection>& conn);
+    void handleWrite(const std::shared_ptr<Connection>& conn);
+
+    // if inBuffer holds a complete request, move it to <request> and return true
+    // (throws dlib::http_parse_error for invalid or too large requests)
+    bool extractRequest(Connection& conn, std::string& request);
+
+    // queue a complete request on the compute pool
+    void dispatch(const std::shared_ptr<Connection>& conn, std::string request);
+
+    // parse, run and queue the response of one request (compute worker)
+    void processRequest(const std::shared_ptr<Connection>& conn, const std::string& request);
+
+    // send an error response and close the connection afterwards
+    void sendError(const std::shared_ptr<Connection>& conn, const std::exception& e);
+
+    void rearm(int fd, uint32_t events);
+    void closeConnection(const std::shared_ptr<Connection>& conn);
+    std::shared_ptr<Connection> findConnection(int fd);
+
+    void cleanup();
+};
+#endif // KAIREACTOR_H
@@ -0,0 +1,68 @@
+#include "KAIResults.h"
+
+json imageResultsToJSON(Image& img, bool includeLandmarks)
+{
+    json results;
+
+    cv::Size imgSize = img.getImageSize();
+    results["image"] = img.getName();
+    results["width"] = imgSize.width;
+    results["height"] = imgSize.height;
+
+    // deadline (partial results)
+    results["partial"] = img.isPartial();
+    results["partialTasks"] = img.getPartialTasks();
+
+    json faces = json::array();
+    auto vFFeatures = img.getFacialFeatures();
+    
+    if (vFFeatures.empty()) {
+        // face detection only: report face boxes
+        for (const auto& faceBbox : img.getImage_faceBboxes()) {
+            const cv::Rect& box = faceBbox.first;
+
+            json face;
+            face["bbox"] = {box.x, box.y, box.width, box.height};
+            face["confidence"] = faceBbox.second;
+            faces.push_back(face);
+        }
+    }
+
+    for (const auto& fFeatures : vFFeatures) {
+        const cv::Rect box = fFeatures.getFaceBbox();
+
+        json face;
+        face["bbox"] = {box.x, box.y, box.width, box.height};
+        face["confidence"] = fFeatures.getFaceConfidence();
+
+        if (includeLandmarks) {
+            json landmarks = json::array();
+            for (const auto& point : fFeatures.getFacialFeatures()) {
+                landmarks.push_back({point.x, point.y});
+            }
+            face["landmarks"] = landmarks;
+        }
+
+        // auxiliary data (only if computed)
+        if (fFeatures.hasAuxData(AuxData::eHeadPose)) {
+            const HeadPose& headPose = fFeatures.getAuxData<HeadPose>();
+            face["headPose"] = {{"roll", headPose.roll},
+                                {"yaw", headPose.yaw},
+                                {"pitch", headPose.pitch}};
+        }
+        if (fFeatures.hasAuxData(AuxData::eMouthOpen)) {
+            face["mouthOpen"] = fFeatures.isMouthOpen();
+        }
+        if (fFeatures.hasAuxData(AuxData::eSmile)) {
+            face["smile"] = fFeatures.isSmileDetected();
+        }
+        if (fFeatures.hasAuxData(AuxData::eEyeglasses)) {
+            face["eyeglasses"] = fFeatures.isEyeglassesDetected();
+        }
+
+        faces.push_back(face);
+    }
+    results["faces"] = faces;
+
+    return results;
+}
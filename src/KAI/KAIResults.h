@@ -0,0 +1,26 @@
+#ifndef KAIRESULTS_H
+#define KAIRESULTS_H
+
+#include <nlohmann/json.hpp>
+
+#include "Image.h"
+
+using json = nlohmann::json;
+
+/**
+ * @brief Serialize KAI results of an image
+ * @note  output format:
+ *  {
+ *    "image": <name>, "width": w, "height": h,
+ *    "partial": bool, "partialTasks": [...],
+ *    "faces": [
+ *      { "bbox": [x, y, w, h], "confidence": c,
+ *        "landmarks": [[x, y], ...],            (facial feature points)
+ *        "headPose": {"roll", "yaw", "pitch"},  (only for available aux data)
+ *        "mouthOpen": s, "smile": s, "eyeglasses": s }
+ *    ]
+ *  }
+ */
+json imageResultsToJSON(Image& img, bool includeLandmarks = true);
+
+#endif // KAIRESULTS_H
@@ -0,0 +1,25 @@
+#ifndef KAISERVER_H
+#define KAISERVER_H
+
+#include <dlib/server.h>
+
+#include "KAIHttpHandler.h"
+
+/**
+ * @brief Embedded HTTP inference endpoint (dlib::server_http, one thread per connection)
+ * @note  see KAIReactor for the event-driven (epoll) variant.
+ */
+class KAIServer : public dlib::server_http {
+public:
+    explicit KAIServer(KAIHttpHandler& requestHandler): handler(requestHandler) {}
+
+private:
+
+    const std::string on_request(const dlib::incoming_things& incoming,
+                                 dlib::outgoing_things& outgoing) override {
+        return handler.handleRequest(incoming, outgoing);
+    }
+
+    KAIHttpHandler& handler;
+};
+#endif // KAISERVER_H
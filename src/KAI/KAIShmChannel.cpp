@@ -0,0 +1,340 @@
+#include "KAIShmChannel.h"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+
+#include <new>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+    size_t alignUp(size_t n, size_t alignment) {
+        return (n + alignment - 1) / alignment * alignment;
+    }
+
+    // absolute CLOCK_REALTIME time in timeoutMs (for sem_timedwait)
+    timespec deadlineIn(int timeoutMs) {
+        timespec ts;
+        clock_gettime(CLOCK_REALTIME, &ts);
+        ts.tv_sec += timeoutMs / 1000;
+        ts.tv_nsec += static_cast<long>(timeoutMs % 1000) * 1000000L;
+        if (ts.tv_nsec >= 1000000000L) {
+            ts.tv_sec += 1;
+            ts.tv_nsec -= 1000000000L;
+        }
+        return ts;
+    }
+
+    // wait on a semaphore, false on timeout
+    bool semWait(sem_t* sem, int timeoutMs) {
+        int ret;
+        if (timeoutMs < 0) {
+            while ((ret = sem_wait(sem)) != 0 && errno == EINTR) {}
+        }
+        else {
+            timespec ts = deadlineIn(timeoutMs);
+            while ((ret = sem_timedwait(sem, &ts)) != 0 && errno == EINTR) {}
+        }
+        return ret == 0;
+    }
+}
+
+KAIShmChannel::~KAIShmChannel()
+{
+    close();
+}
+
+size_t KAIShmChannel::headerSize()
+{
+    return alignUp(sizeof(ChannelHeader), 64);
+}
+
+size_t KAIShmChannel::slotHeaderSize()
+{
+    return alignUp(sizeof(SlotHeader), 64);
+}
+
+void KAIShmChannel::create(const std::string& name, uint32_t numSlots,
+                           size_t pixelCapacity, size_t resultCapacity)
+{
+    if (numSlots == 0 || pixelCapacity == 0 || resultCapacity == 0) {
+        throw std::runtime_error("KAI Shm Channel -- Error: invalid channel size.");
+    }
+
+    close();
+
+    pixelCapacity = alignUp(pixelCapacity, 64);
+    resultCapacity = alignUp(resultCapacity, 64);
+    const size_t slotSize = slotHeaderSize() + pixelCapacity + resultCapacity;
+    const size_t totalSize = headerSize() + numSlots * slotSize;
+
+    // replace a stale segment left by a previous run
+    shm_unlink(name.c_str());
+
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0660);
+    if (fd < 0) {
+        throw std::runtime_error("KAI Shm Channel -- Error: could not create " + name +
+                                 " (" + std::string(strerror(errno)) + ")");
+    }
+
+    if (ftruncate(fd, static_cast<off_t>(totalSize)) != 0) {
+        std::string err = strerror(errno);
+        ::close(fd);
+        shm_unlink(name.c_str());
+        throw std::runtime_error("KAI Shm Channel -- Error: could not size " + name + " (" + err + ")");
+    }
+
+    void* ptr = mmap(nullptr, totalSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (ptr == MAP_FAILED) {
+        shm_unlink(name.c_str());
+        throw std::runtime_error("KAI Shm Channel -- Error: could not map " + name);
+    }
+
+    base = ptr;
+    mappedSize = totalSize;
+    shmName = name;
+    owner = true;
+
+    // initialize header and slots (process-shared semaphores)
+    ChannelHeader* hdr = new (base) ChannelHeader;
+    hdr->numSlots = numSlots;
+    hdr->reserved = 0;
+    hdr->slotSize = slotSize;
+    hdr->pixelCapacity = pixelCapacity;
+    hdr->resultCapacity = resultCapacity;
+    hdr->sequence.store(0);
+    sem_init(&hdr->ready, 1, 0);
+
+    for (uint32_t i = 0; i < numSlots; ++i) {
+        SlotHeader* s = new (slot(i)) SlotHeader;
+        s->state.store(SlotFree);
+        s->width = s->height = s->stride = s->format = 0;
+        s->deadlineMs = 0;
+        s->resultSize = 0;
+        s->reserved = 0;
+        s->sequence = 0;
+        sem_init(&s->done, 1, 0);
+    }
+
+    // publish: clients check magic/version last
+    hdr->version = channelVersion;
+    std::atomic_thread_fence(std::memory_order_release);
+    hdr->magic = channelMagic;
+}
+
+void KAIShmChannel::open(const std::string& name)
+{
+    close();
+
+    int fd = shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0) {
+        throw std::runtime_error("KAI Shm Channel -- Error: could not open " + name +
+                                 " (" + std::string(strerror(errno)) + ")");
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < headerSize()) {
+        ::close(fd);
+        throw std::runtime_error("KAI Shm Channel -- Error: invalid segment " + name);
+    }
+
+    void* ptr = mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (ptr == MAP_FAILED) {
+        throw std::runtime_error("KAI Shm Channel -- Error: could not map " + name);
+    }
+
+    base = ptr;
+    mappedSize = st.st_size;
+    shmName = name;
+    owner = false;
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (header()->magic != channelMagic || header()->version != channelVersion ||
+        headerSize() + header()->numSlots * header()->slotSize > mappedSize) {
+        close();
+        throw std::runtime_error("KAI Shm Channel -- Error: incompatible segment " + name);
+    }
+}
+
+void KAIShmChannel::close()
+{
+    if (base == nullptr) {
+        return;
+    }
+
+    if (owner) {
+        for (uint32_t i = 0; i < header()->numSlots; ++i) {
+            sem_destroy(&slot(i)->done);
+        }
+        sem_destroy(&header()->ready);
+    }
+
+    munmap(base, mappedSize);
+    base = nullptr;
+    mappedSize = 0;
+
+    if (owner) {
+        shm_unlink(shmName.c_str());
+        owner = false;
+    }
+}
+
+KAIShmChannel::SlotHeader* KAIShmChannel::slot(uint32_t i) const
+{
+    uint8_t* p = static_cast<uint8_t*>(base) + headerSize() + i * header()->slotSize;
+    return reinterpret_cast<SlotHeader*>(p);
+}
+
+uint8_t* KAIShmChannel::pixels(uint32_t i) const
+{
+    return reinterpret_cast<uint8_t*>(slot(i)) + slotHeaderSize();
+}
+
+char* KAIShmChannel::results(uint32_t i) const
+{
+    return reinterpret_cast<char*>(pixels(i) + header()->pixelCapacity);
+}
+
+int KAIShmChannel::acquireSlot()
+{
+    const uint32_t n = header()->numSlots;
+    for (uint32_t k = 0; k < n; ++k) {
+        uint32_t i = (clientCursor + k) % n;
+
+        // claim with a CAS so several client threads/processes can share the ring
+        uint32_t expected = SlotFree;
+        if (slot(i)->state.compare_exchange_strong(expected, SlotClaimed)) {
+            clientCursor = (i + 1) % n;
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+bool KAIShmChannel::submit(uint32_t i, uint32_t width, uint32_t height, uint32_t stride,
+                           PixelFormat format, int32_t deadlineMs)
+{
+    static const uint32_t bytesPerPixel[] = {3, 3, 4, 4, 1};
+    if (i >= header()->numSlots || format > GRAY8 || width == 0 || height == 0 ||
+        stride < width * bytesPerPixel[format] ||
+        static_cast<uint64_t>(stride) * height > header()->pixelCapacity) {
+        return false;
+    }
+
+    SlotHeader* s = slot(i);
+    s->width = width;
+    s->height = height;
+    s->stride = stride;
+    s->format = format;
+    s->deadlineMs = deadlineMs;
+    s->resultSize = 0;
+    s->sequence = header()->sequence.fetch_add(1) + 1;
+
+    // publish pixels and header before the state change
+    s->state.store(SlotReady, std::memory_order_release);
+    sem_post(&header()->ready);
+    return true;
+}
+
+bool KAIShmChannel::waitResult(uint32_t i, int timeoutMs)
+{
+    if (!semWait(&slot(i)->done, timeoutMs)) {
+        return false;
+    }
+
+    // complete() posts right before the state change
+    while (slot(i)->state.load(std::memory_order_acquire) == SlotProcessing) {
+        std::this_thread::yield();
+    }
+    return true;
+}
+
+void KAIShmChannel::release(uint32_t i)
+{
+    SlotHeader* s = slot(i);
+
+    uint32_t state = s->state.load(std::memory_order_acquire);
+    while (true) {
+        if (state == SlotFree || state == SlotAbandoned) {
+            return;
+        }
+
+        // KAI reads the pixels in place: complete() frees the slot
+        if (state == SlotProcessing) {
+            if (s->state.compare_exchange_weak(state, SlotAbandoned, std::memory_order_acq_rel)) {
+                return;
+            }
+            continue;
+        }
+
+        // Claimed, Done, Error, or Ready not picked up yet (waitReady claims it with a CAS)
+        if (s->state.compare_exchange_weak(state, SlotFree, std::memory_order_acq_rel)) {
+            break;
+        }
+    }
+
+    // drop a completion the client did not wait for (posted before Done/Error)
+    while (sem_trywait(&s->done) == 0) {}
+}
+
+int KAIShmChannel::waitReady(int timeoutMs)
+{
+    if (!semWait(&header()->ready, timeoutMs)) {
+        return -1;
+    }
+
+    // oldest submission first (clients may submit slots out of ring order)
+    const uint32_t n = header()->numSlots;
+    int next = -1;
+    uint64_t minSequence = UINT64_MAX;
+    for (uint32_t k = 0; k < n; ++k) {
+        uint32_t i = (serverCursor + k) % n;
+        SlotHeader* s = slot(i);
+        if (s->state.load(std::memory_order_acquire) == SlotReady && s->sequence < minSequence) {
+            minSequence = s->sequence;
+            next = static_cast<int>(i);
+        }
+    }
+
+    // the client may release a slot it submitted until KAI picks it up
+    uint32_t expected = SlotReady;
+    if (next < 0 || !slot(next)->state.compare_exchange_strong(expected, SlotProcessing, std::memory_order_acq_rel)) {
+        return -1;
+    }
+
+    serverCursor = (next + 1) % n;
+    return next;
+}
+
+void KAIShmChannel::complete(uint32_t i, const std::string& result, bool error)
+{
+    SlotHeader* s = slot(i);
+
+    if (result.size() > header()->resultCapacity) {
+        static const std::string tooLarge = "{\"error\":\"results exceed the slot capacity\"}";
+        std::memcpy(results(i), tooLarge.data(), tooLarge.size());
+        s->resultSize = static_cast<uint32_t>(tooLarge.size());
+        error = true;
+    }
+    else {
+        std::memcpy(results(i), result.data(), result.size());
+        s->resultSize = static_cast<uint32_t>(result.size());
+    }
+
+    // post first: once the slot leaves Processing, the client may free and reuse it
+    sem_post(&s->done);
+
+    uint32_t expected = SlotProcessing;
+    if (!s->state.compare_exchange_strong(expected, error ? SlotError : SlotDone, std::memory_order_acq_rel)) {
+        // abandoned by the client (e.g., timeout): nobody waits for these results
+        while (sem_trywait(&s->done) == 0) {}
+        s->state.store(SlotFree, std::memory_order_release);
+    }
+}
@@ -0,0 +1,164 @@
+#ifndef KAISHMCHANNEL_H
+#define KAISHMCHANNEL_H
+
+#include <semaphore.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Shared-memory image ingest channel (POSIX shm ring buffer)
+ * @note  Co-located clients place raw pixel buffers into slots of a shared memory segment;
+ *        KAI wraps them as cv::Mat (no copy for BGR8 frames), runs the pipeline and writes
+ *        the JSON results back into the same slot. No encode/decode, no file I/O.
+ *
+ *  segment layout:
+ *      [ChannelHeader][slot 0][slot 1] ... [slot N-1]
+ *  slot layout (slotSize bytes, 64-byte aligned):
+ *      [SlotHeader][pixels (pixelCapacity bytes)][results (resultCapacity bytes)]
+ *
+ *  slot life cycle:
+ *      Free --acquireSlot()--> Claimed --client fills pixels, submit()--> Ready
+ *      Ready --KAI--> Processing --> Done (or Error)
+ *      Done/Error --client reads results, release()--> Free
+ *      Ready --release() before KAI picked it up--> Free
+ *      Processing --release() (e.g., after a timeout)--> Abandoned --KAI done--> Free
+ *      (KAI may still read the pixels of an abandoned slot: it is not reused until then)
+ *
+ *  client usage:
+ *      KAIShmChannel channel;
+ *      channel.open("/kai");
+ *      int slot = channel.acquireSlot();          // -1: all slots busy
+ *      memcpy(channel.pixels(slot), frame, ...);  // or render straight into the slot
+ *      channel.submit(slot, width, height, stride, KAIShmChannel::BGR8);
+ *      if (channel.waitResult(slot, 1000)) { channel.results(slot) ... }
+ *      channel.release(slot);                     // also after a timeout (slot freed by KAI later)
+ */
+class KAIShmChannel {
+public:
+
+    // pixel formats (8 bits per channel)
+    enum PixelFormat : uint32_t {
+        BGR8 = 0,   // native format (zero copy)
+        RGB8,
+        BGRA8,
+        RGBA8,
+        GRAY8
+    };
+
+    enum SlotState : uint32_t {
+        SlotFree = 0,
+        SlotClaimed,    // being filled by a client
+        SlotReady,      // submitted by the client
+        SlotProcessing, // being processed by KAI
+        SlotDone,       // results available
+        SlotError,      // results hold {"error": ...}
+        SlotAbandoned   // released by the client while KAI processes it
+    };
+
+    struct SlotHeader {
+        std::atomic<uint32_t> state;
+        uint32_t width;
+        uint32_t height;
+        uint32_t stride;        // bytes per row
+        uint32_t format;        // PixelFormat
+        int32_t deadlineMs;     // per-image latency budget (0: none)
+        uint32_t resultSize;    // bytes of results (JSON)
+        uint32_t reserved;
+        uint64_t sequence;      // submission counter (set by submit)
+        sem_t done;             // posted when results are available
+    };
+
+    struct ChannelHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t numSlots;
+        uint32_t reserved;
+        uint64_t slotSize;       // bytes per slot
+        uint64_t pixelCapacity;  // max. bytes of pixels per slot
+        uint64_t resultCapacity; // max. bytes of results per slot
+        std::atomic<uint64_t> sequence; // last submission
+        sem_t ready;             // counts submitted slots
+    };
+
+    static const uint32_t channelMagic = 0x4B414953; // "KAIS"
+    static const uint32_t channelVersion = 1;
+
+    KAIShmChannel() = default;
+    ~KAIShmChannel();
+
+    KAIShmChannel(const KAIShmChannel&) = delete;
+    KAIShmChannel& operator=(const KAIShmChannel&) = delete;
+
+    /**
+     * @brief create (and own) a new segment (KAI side)
+     * @param name - shm object name (e.g., "/kai")
+     * @param numSlots - ring size
+     * @param pixelCapacity - max. frame size in bytes (stride x height)
+     * @param resultCapacity - max. results size in bytes
+     * @note  the segment is unlinked when the channel is destroyed
+     */
+    void create(const std::string& name, uint32_t numSlots,
+                size_t pixelCapacity, size_t resultCapacity);
+
+    // attach to an existing segment (client side)
+    void open(const std::string& name);
+
+    bool isOpen() const {return base != nullptr;}
+    uint32_t numSlots() const {return header()->numSlots;}
+    size_t pixelCapacity() const {return header()->pixelCapacity;}
+    size_t resultCapacity() const {return header()->resultCapacity;}
+
+    SlotHeader* slot(uint32_t i) const;
+    uint8_t* pixels(uint32_t i) const;
+    char* results(uint32_t i) const;
+
+    ///
+    // client side
+    ///
+
+    // claim a free slot (round robin), -1 if all slots are busy
+    int acquireSlot();
+
+    // hand a filled slot to KAI
+    bool submit(uint32_t i, uint32_t width, uint32_t height, uint32_t stride,
+                PixelFormat format, int32_t deadlineMs = 0);
+
+    // wait for the results of slot i (timeoutMs < 0: wait forever)
+    bool waitResult(uint32_t i, int timeoutMs = -1);
+
+    // return the slot to the ring (a slot KAI is processing is freed when KAI is done with it)
+    void release(uint32_t i);
+
+    ///
+    // KAI side
+    ///
+
+    // wait for the next submitted slot, -1 on timeout
+    int waitReady(int timeoutMs);
+
+    // store results (JSON) and notify the client (abandoned slots are freed instead)
+    void complete(uint32_t i, const std::string& result, bool error = false);
+
+private:
+
+    std::string shmName;
+    bool owner = false;
+
+    void* base = nullptr;
+    size_t mappedSize = 0;
+
+    uint32_t clientCursor = 0; // next slot to try in acquireSlot()
+    uint32_t serverCursor = 0; // next slot to check in waitReady()
+
+    ChannelHeader* header() const {return static_cast<ChannelHeader*>(base);}
+
+    // bytes reserved for the channel header (64-byte aligned)
+    static size_t headerSize();
+    static size_t slotHeaderSize();
+
+    void close();
+};
+#endif // KAISHMCHANNEL_H
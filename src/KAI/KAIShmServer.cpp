@@ -0,0 +1,92 @@
+#include "KAIShmServer.h"
+#include "KAIResults.h"
+#include "Logger.h"
+
+#include <opencv2/imgproc.hpp>
+
+void KAIShmServer::run()
+{
+    running = true;
+
+    while (running) {
+        // wake up periodically to check for stop()
+        int i = channel.waitReady(200);
+        if (i < 0) {
+            continue;
+        }
+
+        processSlot(static_cast<uint32_t>(i));
+    }
+}
+
+void KAIShmServer::processSlot(uint32_t i)
+{
+    const KAIShmChannel::SlotHeader* slot = channel.slot(i);
+
+    try {
+        // the header is writable by any client: copy it once, then validate the copy
+        // (the same checks as KAIShmChannel::submit) before touching the pixels
+        static const uint64_t bytesPerPixel[] = {3, 3, 4, 4, 1};
+        const uint32_t width = slot->width;
+        const uint32_t height = slot->height;
+        const uint32_t stride = slot->stride;
+        const uint32_t format = slot->format;
+        const uint64_t sequence = slot->sequence;
+        const int32_t slotDeadlineMs = slot->deadlineMs;
+
+        if (format > KAIShmChannel::GRAY8) {
+            channel.complete(i, json{{"error", "unsupported pixel format"}}.dump(), true);
+            return;
+        }
+        if (width == 0 || height == 0 || stride < width * bytesPerPixel[format] ||
+            static_cast<uint64_t>(stride) * height > channel.pixelCapacity()) {
+            channel.complete(i, json{{"error", "invalid image size"}}.dump(), true);
+            return;
+        }
+
+        uint8_t* pixels = channel.pixels(i);
+        const int rows = static_cast<int>(height);
+        const int cols = static_cast<int>(width);
+
+        // wrap the slot pixels (no copy)
+        cv::Mat imgMat;
+        switch (format) {
+            case KAIShmChannel::BGR8:
+                imgMat = cv::Mat(rows, cols, CV_8UC3, pixels, stride);
+                break;
+            case KAIShmChannel::RGB8:
+                cv::cvtColor(cv::Mat(rows, cols, CV_8UC3, pixels, stride), imgMat, cv::COLOR_RGB2BGR);
+                break;
+            case KAIShmChannel::BGRA8:
+                cv::cvtColor(cv::Mat(rows, cols, CV_8UC4, pixels, stride), imgMat, cv::COLOR_BGRA2BGR);
+                break;
+            case KAIShmChannel::RGBA8:
+                cv::cvtColor(cv::Mat(rows, cols, CV_8UC4, pixels, stride), imgMat, cv::COLOR_RGBA2BGR);
+                break;
+            case KAIShmChannel::GRAY8:
+                cv::cvtColor(cv::Mat(rows, cols, CV_8UC1, pixels, stride), imgMat, cv::COLOR_GRAY2BGR);
+                break;
+        }
+
+        Image img(imgMat, "shm-" + std::to_string(sequence));
+
+        int deadlineMs = slotDeadlineMs > 0 ? slotDeadlineMs : defaultDeadlineMs;
+        if (deadlineMs > 0) {
+            img.setDeadline(Deadline(std::chrono::milliseconds(deadlineMs)));
+        }
+
+        taskManager.runTasks(img);
+
+        // feature points may not fit in small result buffers
+        std::string result = imageResultsToJSON(img).dump();
+        if (result.size() > channel.resultCapacity()) {
+            result = imageResultsToJSON(img, false).dump();
+        }
+
+        channel.complete(i, result);
+    }
+    catch (const std::exception& e) {
+        Logger::getInstance().log(ERROR, "[KAI Shm Server]-- Error: " + std::string(e.what()));
+        channel.complete(i, json{{"error", e.what()}}.dump(), true);
+    }
+}
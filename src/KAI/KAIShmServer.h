@@ -0,0 +1,41 @@
+#ifndef KAISHMSERVER_H
+#define KAISHMSERVER_H
+
+#include <atomic>
+#include <string>
+
+#include "KAIShmChannel.h"
+#include "KAITaskManager.h"
+
+/**
+ * @brief Serves a shared-memory ingest channel (see KAIShmChannel)
+ * @note  Frames are wrapped as cv::Mat in place (BGR8: no copy; other formats are
+ *        converted once to BGR), processed by the resident pipeline and the JSON results
+ *        are written back into the slot.
+ */
+class KAIShmServer {
+public:
+    KAIShmServer(KAITaskManager& manager, KAIShmChannel& shmChannel)
+        : taskManager(manager), channel(shmChannel) {}
+
+    // latency budget for slots without a deadline (0: no deadline)
+    void setDefaultDeadlineMs(int ms) {defaultDeadlineMs = ms;}
+
+    // process slots until stop() is called
+    void run();
+
+    // can be called from any thread (or a signal handler)
+    void stop() {running = false;}
+
+private:
+
+    KAITaskManager& taskManager;
+    KAIShmChannel& channel;
+
+    int defaultDeadlineMs = 0;
+    std::atomic<bool> running{false};
+
+    // process one submitted slot
+    void processSlot(uint32_t i);
+};
+#endif // KAISHMSERVER_H
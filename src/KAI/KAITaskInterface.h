@@ -2,6 +2,7 @@
 #define KAITASKINTERFACE_H
 
 #include "Image.h"
+#include "KAIExecConfig.h"
 
 class KAITask{
 public:
@@ -22,9 +23,51 @@ public:
     // Set task's priority
     virtual void setPrecedence(int num) {precedence = num;}
 
+    // Essential tasks (e.g., face detection) are never dropped by the deadline scheduler
+    virtual bool isEssential() const {return essential;}
+
+    // Mark task as essential
+    virtual void setEssential(bool flag) {essential = flag;}
+
+    // Tasks whose results this task needs (e.g., the face records of "FacialFeatures");
+    // they run whenever this task's output is requested
+    virtual std::vector<std::string> getRequirements() const {return requirements;}
+
+    // Set the prerequisite tasks (by name)
+    virtual void setRequirements(const std::vector<std::string>& names) {requirements = names;}
+
+    // Threads the task may use per image (threading policy)
+    // Note: tasks running on OpenCV's global pool (cv::setNumThreads) ignore it
+    virtual void setIntraOpThreads(int /*threads*/) {}
+
+    // Execution settings the auto-tuner may choose from (empty: not tunable)
+    virtual std::vector<KAIExecConfig> getExecCandidates() const {return {};}
+
+    // Apply execution settings (one of getExecCandidates)
+    virtual void setExecConfig(const KAIExecConfig& /*config*/) {}
+
+    // One inference on synthetic input of <batchSize> faces (auto-tuner benchmark)
+    virtual void runSynthetic(int /*batchSize*/) {}
+
+    // true if run() does not allocate once warmed up (buffers, interpreters and scratch are reused);
+    // tasks whose inference library allocates per call (cv::dnn, dlib) are not
+    virtual bool isAllocationFree() const {return false;}
+
+    // Warm-up at load time: the first inference initializes layers, allocates
+    // workspaces and selects kernels, so it is not paid by the first image
+    virtual void warmUp(int runs) {
+        for (int i = 0; i < runs; ++i) {
+            runSynthetic(1);
+        }
+    }
+
 private:
 
     int precedence; // task precedence (lower value = higher priority)
+
+    bool essential = false; // task must run even if the deadline is near
+
+    std::vector<std::string> requirements; // prerequisite task names
     
     std::string taskName; // task name
 };
@@ -9,124 +9,369 @@
 #include "SmileDetector.h"
 #include "EyeglassesDetector.h"
 
+#include "Logger.h"
+
 #include <iostream>
 #include <fstream>
 #include <algorithm>
+#include <chrono>
+#include <sstream>
+
+#include <sys/stat.h>
+
+namespace {
+    // same task params (values and types)
+    bool sameParams(const std::map<std::string, Type>& a, const std::map<std::string, Type>& b) {
+        if (a.size() != b.size()) {
+            return false;
+        }
+        for (const auto& [name, param] : a) {
+            auto it = b.find(name);
+            if (it == b.end() || it->second.type != param.type || !(it->second.value == param.value)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // a reloaded module can keep its task
+    bool sameModule(const MLModule& a, const MLModule& b) {
+        return a.id == b.id && a.version == b.version && a.task == b.task && a.precedence == b.precedence &&
+               a.modelName == b.modelName && a.cfg == b.cfg && sameParams(a.params, b.params);
+    }
+
+    // modification time (ns) and size of a file: saves within the same second still differ
+    struct FileVersion {
+        bool exists = false;
+        long long seconds = 0;
+        long long nanoseconds = 0;
+        long long size = 0;
+
+        bool operator==(const FileVersion& other) const {
+            return exists == other.exists && seconds == other.seconds &&
+                   nanoseconds == other.nanoseconds && size == other.size;
+        }
+    };
+
+    FileVersion getFileVersion(const std::string& path) {
+        FileVersion version;
+        struct stat buffer;
+        if (stat(path.c_str(), &buffer) == 0) {
+            version.exists = true;
+            version.seconds = static_cast<long long>(buffer.st_mtim.tv_sec);
+            version.nanoseconds = static_cast<long long>(buffer.st_mtim.tv_nsec);
+            version.size = static_cast<long long>(buffer.st_size);
+        }
+        return version;
+    }
+}
+
+KAITaskManager::~KAITaskManager()
+{
+    {
+        std::lock_guard<std::mutex> lock(watcherMutex);
+        stopWatching = true;
+    }
+    watcherStop.notify_all();
+
+    if (watcher.joinable()) {
+        watcher.join();
+    }
+}
 
 void KAITaskManager::loadMLConfigs(const std::string config_path)
 {
+    std::lock_guard<std::mutex> lock(reloadMutex);
+    ready = false;
+
+    configPath = config_path;
+    loadedModules.clear();
+
+    std::vector<LoadedModule> modules;
+    std::shared_ptr<KAITaskPipeline> pipeline = buildPipeline(config_path, modules);
+
+    std::atomic_store(&kai_pipeline, pipeline);
+    loadedModules = std::move(modules);
+
+    ready = true;
+}
+
+void KAITaskManager::reloadMLConfigs()
+{
+    std::lock_guard<std::mutex> lock(reloadMutex);
+    Logger& logger = Logger::getInstance();
+
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    // images keep running on the current pipeline meanwhile
+    std::vector<LoadedModule> modules;
+    std::shared_ptr<KAITaskPipeline> pipeline = buildPipeline(configPath, modules);
+
+    // next images run on the new pipeline; images in flight finish on the old one
+    std::atomic_store(&kai_pipeline, pipeline);
+    loadedModules = std::move(modules);
+
+    logger.logInferenceTime("Reload " + configPath, startTime);
+}
+
+void KAITaskManager::watchMLConfigs(int intervalMs)
+{
+    if (watcher.joinable()) {
+        return;
+    }
+
+    // configPath is written by loadMLConfigs (under reloadMutex)
+    auto getConfigPath = [this] {
+        std::lock_guard<std::mutex> lock(reloadMutex);
+        return configPath;
+    };
+
+    watcher = std::thread([this, intervalMs, getConfigPath] {
+        FileVersion lastVersion = getFileVersion(getConfigPath());
+
+        std::unique_lock<std::mutex> lock(watcherMutex);
+        while (!watcherStop.wait_for(lock, std::chrono::milliseconds(intervalMs), [this] {return stopWatching;})) {
+            const std::string path = getConfigPath();
+            FileVersion version = getFileVersion(path);
+            if (!version.exists || version == lastVersion) {
+                continue;
+            }
+            lastVersion = version;
+
+            Logger::getInstance().log(INFO, "[KAI Task Manager]-- " + path + " changed, reloading");
+
+            // the destructor must not wait on watcherMutex for a whole model load (or auto-tuning)
+            lock.unlock();
+            try {
+                reloadMLConfigs();
+            }
+            catch (const std::exception& e) {
+                // e.g., file saved while still being written: kept until the next change
+                Logger::getInstance().log(ERROR, "[KAI Task Manager]-- Error: reload failed, keeping the current pipeline: " +
+                                                 std::string(e.what()));
+            }
+            lock.lock();
+
+            if (stopWatching) {
+                break;
+            }
+        }
+    });
+}
+
+std::shared_ptr<KAITaskPipeline> KAITaskManager::buildPipeline(const std::string& config_path,
+                                                               std::vector<LoadedModule>& modules)
+{
+    auto pipeline = std::make_shared<KAITaskPipeline>();
+
     MLConfigLoader configLoader(config_path);
     
     // do nothing if no task is defined
     if(configLoader.getMLConfigs().empty()){
-        return;
+        return pipeline;
     }
 
     auto vMLModules = configLoader.getMLModules();
 
-    // TODO: add tasks to the pipeline here
     for(const auto& module: vMLModules){
-        std::unique_ptr<KAITask> task;
-
-        std::string str_task = module.task;
-        if(str_task == "FaceDetection"){
-            // read model and cfg files (*.caffemodel and *.prototxt)
-            std::string modelPath = module.modelName;
-            std::string cfgPath = module.cfg;
-            
-            // pass model to constructor
-            FaceDetector* pFaceDetector = new FaceDetector(modelPath, cfgPath);
-
-            // read other task specific params and initialize model
-            auto params = module.params;
-            pFaceDetector->init(params);
-
-            task = std::unique_ptr<KAITask>(pFaceDetector);
+
+        // unchanged module: keep its (loaded, tuned and warmed up) task
+        std::shared_ptr<KAITask> task;
+        for(const auto& loaded: loadedModules){
+            if(sameModule(loaded.module, module)){
+                task = loaded.task;
+                break;
+            }
         }
-        else if(str_task == "FacialFeatures" && module.id == "FFDefault"){
-            // read Dlib model file (*.dat)
-            std::string modelPath = module.modelName;
-            
-            // pass model to constructor
-            task = std::make_unique<FacialFeatureDetector>(modelPath);
+
+        if(task){
+            Logger::getInstance().log(INFO, "[KAI Task Manager]-- Reusing " + module.id +
+                                            " v" + std::to_string(module.version));
         }
-        else if(str_task == "FacialFeatures" && module.id == "FFTFlowLite"){
-            // read tensorflow lite model file (*.tflite)
-            std::string modelPath = module.modelName;
-            
-            // pass model to constructor
-            TFLiteFacialFeatureDetector* pFacialFeatureDetector = 
-                                        new TFLiteFacialFeatureDetector(modelPath);
-
-            // read other task specific params and initialize model
-            auto params = module.params;
-            pFacialFeatureDetector->init(params);
-
-            // pass model to constructor
-            task = std::unique_ptr<KAITask>(pFacialFeatureDetector);
+        else{
+            task = createTask(module);
         }
-        else if(str_task == "FacePose"){
-            // read model and cfg files (*.pb and *.csv)
-            std::string modelPath = module.modelName;
-            std::string cfgPath = module.cfg;
-            
-            // pass model to constructor
-            FacePoseEstimator* pFacePoseEstimator = new FacePoseEstimator(modelPath, cfgPath);
-
-            // read other task specific params and initialize model
-            auto params = module.params;
-            pFacePoseEstimator->init(params);
-
-            task = std::unique_ptr<KAITask>(pFacePoseEstimator);
+
+        if(task){
+            pipeline->addTask(task);
+            modules.push_back({module, task});
         }
-        else if (str_task == "MouthOpen"){
-            // read model filename (*.pb)
-            std::string modelPath = module.modelName;
+    }
 
-            // pass model to constructor
-            MouthOpenDetector* pMouthOpenDetector = new MouthOpenDetector(modelPath);
+    if(autoTuner){
+        autoTuner->save();
+    }
 
-            // read other task specific params and initialize model
-            auto params = module.params;
-            pMouthOpenDetector->init(params);
+    return pipeline;
+}
 
-            task = std::unique_ptr<KAITask>(pMouthOpenDetector);
-        }
-        else if (str_task == "Smile"){
-            // read model filename (*.pb)
-            std::string modelPath = module.modelName;
+std::unique_ptr<KAITask> KAITaskManager::createTask(const MLModule& module)
+{
+    std::unique_ptr<KAITask> task;
 
-            // pass model to constructor
-            SmileDetector* pSmileDetector = new SmileDetector(modelPath);
+    std::string str_task = module.task;
+    if(str_task == "FaceDetection"){
+        // read model and cfg files (*.caffemodel and *.prototxt)
+        std::string modelPath = module.modelName;
+        std::string cfgPath = module.cfg;
+        
+        // pass model to constructor
+        FaceDetector* pFaceDetector = new FaceDetector(modelPath, cfgPath);
 
-            // read other task specific params and initialize model
-            auto params = module.params;
-            pSmileDetector->init(params);
+        // read other task specific params and initialize model
+        auto params = module.params;
+        pFaceDetector->init(params);
 
-            task = std::unique_ptr<KAITask>(pSmileDetector);
-        }
-        else if (str_task == "Eyeglasses"){
-            // read model filename (*.pb)
-            std::string modelPath = module.modelName;
+        task = std::unique_ptr<KAITask>(pFaceDetector);
+    }
+    else if(str_task == "FacialFeatures" && module.id == "FFDefault"){
+        // read Dlib model file (*.dat)
+        std::string modelPath = module.modelName;
+        
+        // pass model to constructor
+        FacialFeatureDetector* pFacialFeatureDetector = new FacialFeatureDetector(modelPath);
+
+        // read other task specific params (e.g., ROI-local landmarking)
+        auto params = module.params;
+        pFacialFeatureDetector->init(params);
+
+        task = std::unique_ptr<KAITask>(pFacialFeatureDetector);
+    }
+    else if(str_task == "FacialFeatures" && module.id == "FFTFlowLite"){
+        // read tensorflow lite model file (*.tflite)
+        std::string modelPath = module.modelName;
+        
+        // pass model to constructor
+        TFLiteFacialFeatureDetector* pFacialFeatureDetector = 
+                                    new TFLiteFacialFeatureDetector(modelPath);
+
+        // read other task specific params and initialize model
+        auto params = module.params;
+        pFacialFeatureDetector->init(params);
+
+        // pass model to constructor
+        task = std::unique_ptr<KAITask>(pFacialFeatureDetector);
+    }
+    else if(str_task == "FacePose"){
+        // read model and cfg files (*.pb and *.csv)
+        std::string modelPath = module.modelName;
+        std::string cfgPath = module.cfg;
+        
+        // pass model to constructor
+        FacePoseEstimator* pFacePoseEstimator = new FacePoseEstimator(modelPath, cfgPath);
+
+        // read other task specific params and initialize model
+        auto params = module.params;
+        pFacePoseEstimator->init(params);
+
+        task = std::unique_ptr<KAITask>(pFacePoseEstimator);
+    }
+    else if (str_task == "MouthOpen"){
+        // read model filename (*.pb)
+        std::string modelPath = module.modelName;
+
+        // pass model to constructor
+        MouthOpenDetector* pMouthOpenDetector = new MouthOpenDetector(modelPath);
+
+        // read other task specific params and initialize model
+        auto params = module.params;
+        pMouthOpenDetector->init(params);
+
+        task = std::unique_ptr<KAITask>(pMouthOpenDetector);
+    }
+    else if (str_task == "Smile"){
+        // read model filename (*.pb)
+        std::string modelPath = module.modelName;
 
-            // pass model to constructor
-            EyeglassesDetector* pEyeglassesDetector = new EyeglassesDetector(modelPath);
+        // pass model to constructor
+        SmileDetector* pSmileDetector = new SmileDetector(modelPath);
 
-            // read other task specific params and initialize model
-            auto params = module.params;
-            pEyeglassesDetector->init(params);
+        // read other task specific params and initialize model
+        auto params = module.params;
+        pSmileDetector->init(params);
 
-            task = std::unique_ptr<KAITask>(pEyeglassesDetector);
+        task = std::unique_ptr<KAITask>(pSmileDetector);
+    }
+    else if (str_task == "Eyeglasses"){
+        // read model filename (*.pb)
+        std::string modelPath = module.modelName;
+
+        // pass model to constructor
+        EyeglassesDetector* pEyeglassesDetector = new EyeglassesDetector(modelPath);
+
+        // read other task specific params and initialize model
+        auto params = module.params;
+        pEyeglassesDetector->init(params);
+
+        task = std::unique_ptr<KAITask>(pEyeglassesDetector);
+    }
+
+    if(task){
+        task->setName(module.task);
+        task->setPrecedence(module.precedence);
+        
+        // face boxes and landmarks are prerequisites for all other tasks;
+        // the deadline scheduler may cut them short but never drops them
+        task->setEssential(str_task == "FaceDetection" || str_task == "FacialFeatures");
+
+        // landmarking creates the face records the per-face classifiers fill in
+        if(str_task == "FacialFeatures"){
+            task->setRequirements({"FaceDetection"});
+        }
+        else if(str_task != "FaceDetection"){
+            task->setRequirements({"FacialFeatures"});
         }
 
-        if(task){
-            task->setName(module.task);
-            task->setPrecedence(module.precedence);
-            kai_pipeline.addTask(std::move(task));
+        if(intraOpThreads > 0){
+            task->setIntraOpThreads(intraOpThreads);
+        }
+
+        // benchmark (or read cached) execution settings for this machine
+        if(autoTuner){
+            autoTuner->tune(*task, KAIAutoTuner::getModelKey(module.id, module.modelName,
+                                                             module.version, intraOpThreads));
+        }
+
+        // first inference (layer init, workspace allocation) before the first image
+        if(warmUpRuns > 0){
+            auto startTime = std::chrono::high_resolution_clock::now();
+            task->warmUp(warmUpRuns);
+            Logger::getInstance().logInferenceTime("Warm-up " + module.task, startTime);
         }
     }
+    return task;
 }
 
 void KAITaskManager::runTasks(Image& img){
-    kai_pipeline.runPipeline(img);
-}
\ No newline at end of file
+    // the pipeline stays alive until this image is done, even if a reload swaps it
+    std::shared_ptr<KAITaskPipeline> pipeline = std::atomic_load(&kai_pipeline);
+    pipeline->runPipeline(img);
+}
+
+bool KAITaskManager::hasTask(const std::string& name) const{
+    return std::atomic_load(&kai_pipeline)->hasTask(name);
+}
+
+std::vector<std::shared_ptr<KAITask>> KAITaskManager::getTasks() const{
+    return std::atomic_load(&kai_pipeline)->getTasks();
+}
+
+std::vector<std::string> KAITaskManager::parseTaskList(const std::string& list){
+    std::vector<std::string> tasks;
+    std::stringstream ss(list);
+    std::string name;
+    while (std::getline(ss, name, ',')) {
+        // trim spaces
+        name.erase(0, name.find_first_not_of(' '));
+        name.erase(name.find_last_not_of(' ') + 1);
+        if (!name.empty()) {
+            tasks.push_back(name);
+        }
+    }
+    return tasks;
+}
+
+void KAITaskManager::setThreadingPolicy(const KAIThreadingPolicy& policy){
+    intraOpThreads = policy.getIntraOpThreads();
+    std::atomic_load(&kai_pipeline)->setIntraOpThreads(intraOpThreads);
+}
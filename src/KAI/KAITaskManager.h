@@ -3,11 +3,18 @@
 
 // #include <nlohmann/json.hpp>
 
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "MLConfigLoader.h"
 #include "KAITaskPipeline.h"
+#include "KAIThreadingPolicy.h"
+#include "KAIAutoTuner.h"
 
 
 // using json = nlohmann::json;
@@ -15,14 +22,99 @@
 class KAITaskManager {
 public:
     //KAITaskManager();
+
+    // stops the config watcher
+    ~KAITaskManager();
     
     void loadMLConfigs(const std::string config_path);
 
     void runTasks(Image& image);
 
+    /**
+     * @brief hot reload: re-read the MLConfig and swap in the new pipeline
+     * @note  the new pipeline is built on the calling thread while images keep running on
+     *        the current one; it is then swapped in atomically (images in flight finish on
+     *        the old pipeline, which is released with the last of them).
+     *        Modules with the same id, version, precedence, files and params are reused
+     *        as is (no reload, no warm-up); the others are loaded, tuned and warmed up.
+     *        Reused tasks are shared by both pipelines: like runTasks, images must not be
+     *        processed concurrently on one manager (callers serialize runTasks).
+     * @throws on an invalid config or a model that cannot be loaded (the current pipeline is kept)
+     */
+    void reloadMLConfigs();
+
+    /**
+     * @brief reload the MLConfig whenever the file changes (polls its modification time and size)
+     * @note  reload errors are logged and the current pipeline is kept
+     */
+    void watchMLConfigs(int intervalMs = 1000);
+
+    /**
+     * @brief per-task threads from the threading policy (e.g., TFLite interpreter threads)
+     * @note  applies to loaded tasks and to tasks loaded later; process-wide settings
+     *        (OpenCV, dlib) are made by KAIThreadingPolicy::applyGlobal
+     */
+    void setThreadingPolicy(const KAIThreadingPolicy& policy);
+
+    /**
+     * @brief select the fastest execution settings of each task at load time
+     * @note  must be set before loadMLConfigs; nullptr: task defaults
+     */
+    void setAutoTuner(KAIAutoTuner* tuner) {autoTuner = tuner;}
+
+    // synthetic inference runs per task at load time (0: no warm-up)
+    void setWarmUpRuns(int runs) {warmUpRuns = runs;}
+
+    // true once all tasks are loaded and warmed up
+    bool isReady() const {return ready.load();}
+
+    // true if the loaded pipeline has task <name> (e.g., to validate requested outputs)
+    bool hasTask(const std::string& name) const;
+
+    // tasks of the loaded pipeline in run order
+    std::vector<std::shared_ptr<KAITask>> getTasks() const;
+
+    // "FaceDetection,Smile" -> {"FaceDetection", "Smile"} (requested outputs, see Image::setRequestedTasks)
+    static std::vector<std::string> parseTaskList(const std::string& list);
+
 private:
-    
-    KAITaskPipeline kai_pipeline;
+
+    // task of <module> (nullptr for unknown tasks), tuned and warmed up
+    std::unique_ptr<KAITask> createTask(const MLModule& module);
+
+    // modules of a pipeline and their tasks
+    struct LoadedModule {
+        MLModule module;
+        std::shared_ptr<KAITask> task;
+    };
+
+    // pipeline of the MLConfig, reusing the unchanged tasks of the current one
+    // <modules>: modules of the new pipeline
+    std::shared_ptr<KAITaskPipeline> buildPipeline(const std::string& config_path,
+                                                   std::vector<LoadedModule>& modules);
+
+    // current pipeline (std::atomic_load/atomic_store: swapped by reloads while images run)
+    std::shared_ptr<KAITaskPipeline> kai_pipeline = std::make_shared<KAITaskPipeline>();
+
+    // modules of the current pipeline (guarded by reloadMutex)
+    std::vector<LoadedModule> loadedModules;
+    std::string configPath;
+    std::mutex reloadMutex; // one load/reload at a time
+
+    // config watcher
+    std::thread watcher;
+    std::mutex watcherMutex;
+    std::condition_variable watcherStop;
+    bool stopWatching = false;
+
+    // threads per task (0: library defaults)
+    int intraOpThreads = 0;
+
+    // optional startup auto-tuning (not owned)
+    KAIAutoTuner* autoTuner = nullptr;
+
+    int warmUpRuns = 1;
+    std::atomic<bool> ready{false};
 };
 
 #endif // KAITASKMANAGER_H
\ No newline at end of file
@@ -4,42 +4,160 @@
 #include <algorithm>
 #include <chrono>
 
-// Add task to the pipeline
-void KAITaskPipeline::addTask(std::unique_ptr<KAITask> task) {
+// Add task to the pipeline (kept sorted by precedence)
+void KAITaskPipeline::addTask(std::shared_ptr<KAITask> task) {
     taskQueue.push_back(std::move(task));
+    sortTasksByPriority();
 }
 
 // Sort the tasks based on their priority
+// Note: the queue is only reordered when tasks are added, never by runPipeline:
+//       an image paused at a task boundary (scheduler) resumes at the right task
 void KAITaskPipeline::sortTasksByPriority() {
-    std::sort(taskQueue.begin(), taskQueue.end(),
-            [](const std::unique_ptr<KAITask>& a, const std::unique_ptr<KAITask>& b)
+    std::stable_sort(taskQueue.begin(), taskQueue.end(),
+            [](const std::shared_ptr<KAITask>& a, const std::shared_ptr<KAITask>& b)
             {
                 return a->getPrecedence() < b->getPrecedence();
             });
 }
 
+void KAITaskPipeline::setIntraOpThreads(int threads) {
+    for (auto& task : taskQueue) {
+        task->setIntraOpThreads(threads);
+    }
+}
+
+bool KAITaskPipeline::hasTask(const std::string& name) const {
+    for (const auto& task : taskQueue) {
+        if (task->getName() == name) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::set<std::string> KAITaskPipeline::getRequiredTasks(const std::vector<std::string>& requested) const {
+    std::set<std::string> required;
+    std::vector<std::string> pending(requested);
+    while (!pending.empty()) {
+        std::string name = pending.back();
+        pending.pop_back();
+        if (!required.insert(name).second) {
+            continue;
+        }
+
+        for (const auto& task : taskQueue) {
+            if (task->getName() == name) {
+                for (const auto& prerequisite : task->getRequirements()) {
+                    pending.push_back(prerequisite);
+                }
+            }
+        }
+    }
+    return required;
+}
+
 // Execute all tasks in the sorted order
 void KAITaskPipeline::runPipeline(Image& img) {
 
-    // Sort the tasks before executing
-    sortTasksByPriority();
-
     // logging 
+    // Note: messages are only formatted if written (no allocations per image otherwise)
     Logger& logger = Logger::getInstance();
-    logger.log(INFO, "Processing image: " + img.getName());
+    const bool verbose = logger.isEnabled(INFO);
+    if (verbose) {
+        logger.log(INFO, "Processing image: " + img.getName());
+    }
+
+    // requested outputs only (and their prerequisites); empty request: all tasks
+    const std::vector<std::string>& requested = img.getRequestedTasks();
+    const std::set<std::string> required = getRequiredTasks(requested);
 
     // Execute each task in sequence, passing the bounding boxes
+    bool taskRan = false;
     for (auto& task : taskQueue) {
+
+        if (!requested.empty() && required.count(task->getName()) == 0) {
+            if (verbose) {
+                logger.log(INFO, "Skipping task: " + task->getName() + " (not requested)");
+            }
+            continue;
+        }
+
+        // task boundary: the image may be paused here (priority scheduling)
+        // Note: before the deadline check, which then accounts for the pause
+        if (taskRan) {
+            img.onTaskBoundary();
+        }
+
+        // Deadline check: drop non-essential tasks that do not fit in the remaining budget
+        // (tasks are sorted by precedence, so lower-priority tasks are dropped first)
+        if (!task->isEssential() && !fitsInBudget(*task, img)) {
+            if (verbose) {
+                logger.log(INFO, "Skipping task: " + task->getName() + " (deadline)");
+            }
+            img.markPartial(task->getName());
+            continue;
+        }
+
         // logging - [task name]
-        logger.log(INFO, "Starting task: " + task->getName());
+        if (verbose) {
+            logger.log(INFO, "Starting task: " + task->getName());
+        }
         
         auto startTime = std::chrono::high_resolution_clock::now();
         
         // Run task
+        // Note: tasks check img.isBudgetExhausted() between faces and
+        //       stop early (partial results) once the deadline has passed
         // TODO: handle errors at top-level (?)
         task->run(img);       
         
         // logging - [task inference time]
         logger.logInferenceTime(task->getName(), startTime);
+
+        auto endTime = std::chrono::high_resolution_clock::now();
+        double elapsedMs = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+        updateTaskCost(*task, elapsedMs, img.getImage_faceBboxesRef().size());
+        taskRan = true;
+    }
+
+    if (img.isPartial() && verbose) {
+        logger.log(INFO, "Deadline reached: returning partial results for image " + img.getName());
+    }
+}
+
+bool KAITaskPipeline::fitsInBudget(const KAITask& task, const Image& img) const {
+    
+    const Deadline& deadline = img.getDeadline();
+    if (!deadline.isBounded()) {
+        return true;
+    }
+
+    double remainingMs = deadline.remainingMs();
+    if (remainingMs <= 0.0) {
+        return false;
     }
-}
\ No newline at end of file
+
+    // no estimate yet: give the task a chance
+    auto it = taskCostPerFace.find(task.getName());
+    if (it == taskCostPerFace.end()) {
+        return true;
+    }
+
+    // task is dropped only if it cannot process even the first (most important) face;
+    // otherwise it runs in degraded mode and stops between faces when the budget runs out
+    return it->second <= remainingMs;
+}
+
+void KAITaskPipeline::updateTaskCost(const KAITask& task, double elapsedMs, size_t numFaces) {
+    
+    double costPerFace = elapsedMs / static_cast<double>(std::max<size_t>(numFaces, 1));
+
+    auto it = taskCostPerFace.find(task.getName());
+    if (it == taskCostPerFace.end()) {
+        taskCostPerFace[task.getName()] = costPerFace;
+    }
+    else {
+        it->second = costSmoothing * costPerFace + (1.0 - costSmoothing) * it->second;
+    }
+}
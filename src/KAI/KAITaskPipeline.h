@@ -3,16 +3,45 @@
 
 #include <vector>
 #include <memory>
+#include <map>
+#include <set>
+#include <string>
 
 #include "KAITaskInterface.h"
 
 class KAITaskPipeline {
 private:
-    std::vector<std::unique_ptr<KAITask>> taskQueue;
+    // tasks may be shared with the next pipeline of a config reload (unchanged modules)
+    std::vector<std::shared_ptr<KAITask>> taskQueue;
+
+    // running estimate of each task's cost (ms per face)
+    // used to decide if a task still fits in the image's deadline
+    std::map<std::string, double> taskCostPerFace;
+
+    // smoothing factor for the cost estimates (exponential moving average)
+    const double costSmoothing = 0.3;
+
+    // true if task <task> is expected to finish within the image's deadline
+    bool fitsInBudget(const KAITask& task, const Image& img) const;
+
+    // update cost estimate of <task> after a run
+    void updateTaskCost(const KAITask& task, double elapsedMs, size_t numFaces);
+
+    // <requested> tasks and their prerequisites (transitively)
+    std::set<std::string> getRequiredTasks(const std::vector<std::string>& requested) const;
 
 public:
-    void addTask(std::unique_ptr<KAITask> task);
+    void addTask(std::shared_ptr<KAITask> task);
     void runPipeline(Image& img);
     void sortTasksByPriority();
+
+    // threads each task may use per image (threading policy)
+    void setIntraOpThreads(int threads);
+
+    // true if the pipeline has a task named <name>
+    bool hasTask(const std::string& name) const;
+
+    // tasks in run order
+    const std::vector<std::shared_ptr<KAITask>>& getTasks() const {return taskQueue;}
 };
-#endif // KAITASKPIPELINE_H
\ No newline at end of file
+#endif // KAITASKPIPELINE_H
@@ -0,0 +1,194 @@
+#include "KAIThreadingPolicy.h"
+#include "Logger.h"
+
+#include <opencv2/core.hpp>
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+namespace {
+    // sysfs cpu list, e.g. "0-3,8-11"
+    std::vector<int> parseCpuList(const std::string& list) {
+        std::vector<int> cpus;
+        std::stringstream ss(list);
+        std::string range;
+        while (std::getline(ss, range, ',')) {
+            size_t dash = range.find('-');
+            try {
+                int first = std::stoi(range.substr(0, dash));
+                int last = (dash == std::string::npos) ? first : std::stoi(range.substr(dash + 1));
+                for (int cpu = first; cpu <= last; ++cpu) {
+                    cpus.push_back(cpu);
+                }
+            }
+            catch (const std::exception&) {
+                // skip malformed entries
+            }
+        }
+        return cpus;
+    }
+}
+
+void KAIThreadingPolicy::captureCores()
+{
+    if (processCores.empty()) {
+        processCores = getAvailableCores();
+    }
+}
+
+int KAIThreadingPolicy::getTotalCores() const
+{
+    const std::vector<int> cores = processCores.empty() ? getAvailableCores() : processCores;
+    const int available = static_cast<int>(cores.size());
+    return totalCores > 0 ? std::min(totalCores, available) : available;
+}
+
+int KAIThreadingPolicy::getIntraOpThreads() const
+{
+    if (intraOpThreads > 0) {
+        return intraOpThreads;
+    }
+    return std::max(1, getTotalCores() / std::max(1, interImageWorkers));
+}
+
+void KAIThreadingPolicy::applyGlobal()
+{
+    captureCores();
+
+    const int threads = getIntraOpThreads();
+
+    // OpenCV (DNN layers, resize, color conversion)
+    cv::setNumThreads(threads);
+
+    // dlib's default thread pool is sized on first use
+    setenv("DLIB_NUM_THREADS", std::to_string(threads).c_str(), 0);
+
+    Logger::getInstance().log(INFO, "[KAI Threading]-- " + std::to_string(getTotalCores()) + " core(s): " +
+                                    std::to_string(interImageWorkers) + " worker(s) x " +
+                                    std::to_string(threads) + " intra-op thread(s)" +
+                                    (pinWorkers ? " (pinned" + std::string(numaLocal ? ", NUMA-local)" : ")") : ""));
+}
+
+std::vector<int> KAIThreadingPolicy::getWorkerCores(int index) const
+{
+    std::vector<int> available = processCores.empty() ? getAvailableCores() : processCores;
+    available.resize(static_cast<size_t>(getTotalCores()));
+    if (available.empty()) {
+        return available;
+    }
+
+    const size_t sliceSize = std::min(available.size(), static_cast<size_t>(getIntraOpThreads()));
+
+    // core slices of <sliceSize> cores
+    std::vector<std::vector<int>> slices;
+    if (numaLocal) {
+        // slices never span nodes; consecutive workers alternate between nodes
+        std::vector<std::vector<std::vector<int>>> nodeSlices;
+        for (const auto& node : getNumaNodes()) {
+            std::vector<int> cores;
+            for (int cpu : node) {
+                if (std::find(available.begin(), available.end(), cpu) != available.end()) {
+                    cores.push_back(cpu);
+                }
+            }
+
+            std::vector<std::vector<int>> perNode;
+            for (size_t first = 0; first + sliceSize <= cores.size(); first += sliceSize) {
+                perNode.emplace_back(cores.begin() + first, cores.begin() + first + sliceSize);
+            }
+            if (!perNode.empty()) {
+                nodeSlices.push_back(perNode);
+            }
+        }
+
+        for (size_t i = 0; !nodeSlices.empty(); ++i) {
+            bool added = false;
+            for (const auto& perNode : nodeSlices) {
+                if (i < perNode.size()) {
+                    slices.push_back(perNode[i]);
+                    added = true;
+                }
+            }
+            if (!added) {
+                break;
+            }
+        }
+    }
+
+    // contiguous slices (also when the nodes are smaller than a slice)
+    if (slices.empty()) {
+        for (size_t first = 0; first + sliceSize <= available.size(); first += sliceSize) {
+            slices.emplace_back(available.begin() + first, available.begin() + first + sliceSize);
+        }
+    }
+
+    return slices[static_cast<size_t>(std::max(0, index)) % slices.size()];
+}
+
+bool KAIThreadingPolicy::pinCurrentThread(int index) const
+{
+    if (!pinWorkers) {
+        return false;
+    }
+
+    std::vector<int> cores = getWorkerCores(index);
+    if (cores.empty()) {
+        return false;
+    }
+
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    for (int cpu : cores) {
+        CPU_SET(cpu, &cpuSet);
+    }
+
+    if (pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet) != 0) {
+        Logger::getInstance().log(ERROR, "[KAI Threading]-- Could not pin worker " + std::to_string(index));
+        return false;
+    }
+    return true;
+}
+
+std::vector<int> KAIThreadingPolicy::getAvailableCores()
+{
+    std::vector<int> cores;
+
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    if (sched_getaffinity(0, sizeof(cpuSet), &cpuSet) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &cpuSet)) {
+                cores.push_back(cpu);
+            }
+        }
+    }
+
+    if (cores.empty()) {
+        cores.push_back(0);
+    }
+    return cores;
+}
+
+std::vector<std::vector<int>> KAIThreadingPolicy::getNumaNodes()
+{
+    std::vector<std::vector<int>> nodes;
+    for (int node = 0; ; ++node) {
+        std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+        std::string list;
+        if (!file || !std::getline(file, list)) {
+            break;
+        }
+        nodes.push_back(parseCpuList(list));
+    }
+
+    if (nodes.empty()) {
+        nodes.push_back(getAvailableCores());
+    }
+    return nodes;
+}
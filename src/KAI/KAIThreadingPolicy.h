@@ -0,0 +1,65 @@
+#ifndef KAITHREADINGPOLICY_H
+#define KAITHREADINGPOLICY_H
+
+#include <vector>
+
+/**
+ * @brief Process-wide threading layout (OpenCV, TFLite and dlib)
+ * @note  The cores are split between images processed in parallel (inter-image workers)
+ *        and the threads each worker's tasks may use (intra-op threads), so that
+ *        workers x intra-op threads == cores instead of every library sizing its own
+ *        pool to the whole machine.
+ *
+ *        KAIThreadingPolicy policy;
+ *        policy.interImageWorkers = 8;   // e.g. batch inference instances
+ *        policy.pinWorkers = true;
+ *        policy.applyGlobal();           // cv::setNumThreads, dlib default pool
+ *        manager.setThreadingPolicy(policy);
+ *        ...
+ *        // in worker i (before building its task manager, so that library thread pools
+ *        // and model memory are created on the worker's cores / NUMA node):
+ *        policy.pinCurrentThread(i);
+ */
+struct KAIThreadingPolicy {
+    int totalCores = 0;         // 0: all CPUs available to the process (affinity mask)
+    int interImageWorkers = 1;  // images processed in parallel
+    int intraOpThreads = 0;     // threads per task (0: totalCores / interImageWorkers)
+    bool pinWorkers = false;    // pin each worker to its own cores
+    bool numaLocal = false;     // a worker's cores never span NUMA nodes
+
+    // CPUs of the process, captured before any worker is pinned (empty: not captured yet)
+    // Note: pinned workers only see their own slice in the affinity mask
+    std::vector<int> processCores;
+
+    // capture the process' affinity mask (no-op if already captured)
+    // called by applyGlobal; call it before pinning workers otherwise
+    void captureCores();
+
+    // cores used by the process
+    int getTotalCores() const;
+
+    // threads per task
+    int getIntraOpThreads() const;
+
+    /**
+     * @brief process-wide settings
+     * @note  cv::setNumThreads(intra-op threads) and the size of dlib's default thread pool
+     *        (DLIB_NUM_THREADS, unless set by the user); must be called before dlib's pool is used
+     *        and before any worker is pinned (captures the process' cores)
+     */
+    void applyGlobal();
+
+    // cores of worker <index> (workers beyond the number of core slices share them round-robin)
+    std::vector<int> getWorkerCores(int index) const;
+
+    // pin the calling thread (and the threads it creates later) to the cores of worker <index>
+    // returns false if pinning is disabled or failed
+    bool pinCurrentThread(int index) const;
+
+    // CPUs in the calling thread's affinity mask
+    static std::vector<int> getAvailableCores();
+
+    // CPUs of each NUMA node (from sysfs; a single node if unavailable)
+    static std::vector<std::vector<int>> getNumaNodes();
+};
+#endif // KAITHREADINGPOLICY_H
@@ -13,6 +13,7 @@ Logger& Logger::getInstance() {
 Logger::Logger() {}
 
 void Logger::setLogFile(const std::string& fileName) {
+    std::lock_guard<std::mutex> lock(logMutex);
     if (logFile.is_open()) {
         logFile.close();
     }
@@ -26,8 +27,13 @@ Logger::~Logger() {
 }
 
 void Logger::log(LogLevel level, const std::string& message) {
+    if (!isEnabled(level)) {
+        return;
+    }
+
     std::string logMessage = "[" + getCurrentTime() + "] " + logLevelToString(level) + ": " + message;
     
+    std::lock_guard<std::mutex> lock(logMutex);
     if (logFile.is_open()) {
         logFile << logMessage << std::endl;
     }
@@ -38,7 +44,10 @@ void Logger::log(LogLevel level, const std::string& message) {
 
 void Logger::logInferenceTime(const std::string& taskName, 
         const std::chrono::time_point<std::chrono::high_resolution_clock>& startTime) {
-    
+    if (!isEnabled(INFO)) {
+        return;
+    }
+
     auto endTime = std::chrono::high_resolution_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime).count();
     std::string message = "Task: " + taskName + " completed in " + std::to_string(duration) + " ms";
@@ -49,7 +58,9 @@ std::string Logger::getCurrentTime() const {
     auto now = std::chrono::system_clock::now();
     std::time_t nowTime = std::chrono::system_clock::to_time_t(now);
     std::stringstream ss;
-    ss << std::put_time(std::localtime(&nowTime), "%Y-%m-%d %H:%M:%S");
+    std::tm localTime;
+    localtime_r(&nowTime, &localTime); // thread-safe localtime
+    ss << std::put_time(&localTime, "%Y-%m-%d %H:%M:%S");
     return ss.str();
 }
 
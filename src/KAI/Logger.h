@@ -1,9 +1,11 @@
 #ifndef LOGGER_H
 #define LOGGER_H
 
+#include <atomic>
 #include <string>
 #include <fstream>
 #include <chrono>
+#include <mutex>
 
 enum LogLevel {
     INFO,
@@ -19,6 +21,12 @@ public:
     // Sets the log file output
     void setLogFile(const std::string& fileName);
 
+    // Messages below <level> are dropped (INFO < DEBUG < ERROR; default: all messages)
+    void setLevel(LogLevel level) {minLevel = level;}
+
+    // true if messages of <level> are written (callers skip formatting dropped messages)
+    bool isEnabled(LogLevel level) const {return level >= minLevel.load();}
+
     // Logs messages at different levels
     void log(LogLevel level, const std::string& message);
     
@@ -35,6 +43,11 @@ private:
     
     std::ofstream logFile;
 
+    // serializes log writes (requests may be processed concurrently)
+    std::mutex logMutex;
+
+    std::atomic<LogLevel> minLevel{INFO};
+
     // Helper function to get current timestamp
     std::string getCurrentTime() const;
 
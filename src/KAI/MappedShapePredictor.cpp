@@ -0,0 +1,236 @@
+#include "MappedShapePredictor.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace {
+    const char cacheMagic[8] = {'K', 'A', 'I', 'S', 'P', '0', '0', '2'};
+
+    // arrays start on page boundaries
+    const size_t sectionAlignment = 4096;
+
+    struct CacheHeader {
+        char magic[8];
+        uint64_t sourceSize;   // dlib model file size
+        int64_t sourceMTime;   // dlib model modification time (seconds)
+        uint32_t shapeSize;
+        uint32_t numCascades;
+        uint32_t numTrees;
+        uint32_t numSplits;
+        uint32_t numFeatures;
+        uint32_t sourceMTimeNsec;   // nanoseconds part (a rewrite within the same second is detected)
+        uint64_t initialShapeOffset;
+        uint64_t anchorsOffset;
+        uint64_t deltasOffset;
+        uint64_t splitsOffset;
+        uint64_t leavesOffset;
+        uint64_t fileSize;
+    };
+
+    size_t alignUp(size_t n) {
+        return (n + sectionAlignment - 1) / sectionAlignment * sectionAlignment;
+    }
+
+    // zero padding up to <offset>
+    void padTo(std::ofstream& out, uint64_t offset) {
+        static const char zeros[sectionAlignment] = {};
+        const uint64_t current = static_cast<uint64_t>(out.tellp());
+        if (offset > current) {
+            out.write(zeros, static_cast<std::streamsize>(offset - current));
+        }
+    }
+
+    bool readHeader(const std::string& cachePath, CacheHeader& header) {
+        std::ifstream file(cachePath, std::ios::binary);
+        return file.read(reinterpret_cast<char*>(&header), sizeof(header)) &&
+               std::memcmp(header.magic, cacheMagic, sizeof(cacheMagic)) == 0;
+    }
+}
+
+MappedShapePredictor::MappedShapePredictor(const std::string& cachePath)
+{
+    int fd = open(cachePath.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("[KAI Model Store]-- Error: could not open " + cachePath);
+    }
+
+    struct stat buffer;
+    if (fstat(fd, &buffer) != 0 || static_cast<size_t>(buffer.st_size) < sizeof(CacheHeader)) {
+        close(fd);
+        throw std::runtime_error("[KAI Model Store]-- Error: invalid model cache " + cachePath);
+    }
+
+    // read-only shared mapping: one physical copy for all processes
+    mappingSize = static_cast<size_t>(buffer.st_size);
+    mapping = mmap(nullptr, mappingSize, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        mapping = nullptr;
+        throw std::runtime_error("[KAI Model Store]-- Error: could not map " + cachePath);
+    }
+
+    const char* base = static_cast<const char*>(mapping);
+    CacheHeader header;
+    std::memcpy(&header, base, sizeof(header));
+
+    const bool valid = std::memcmp(header.magic, cacheMagic, sizeof(cacheMagic)) == 0 &&
+                       header.fileSize == mappingSize && header.leavesOffset <= mappingSize &&
+                       header.shapeSize > 0 && header.numCascades > 0;
+    if (!valid) {
+        munmap(mapping, mappingSize);
+        mapping = nullptr;
+        throw std::runtime_error("[KAI Model Store]-- Error: invalid model cache " + cachePath);
+    }
+
+    shapeSize = header.shapeSize;
+    numCascades = header.numCascades;
+    numTrees = header.numTrees;
+    numSplits = header.numSplits;
+    numFeatures = header.numFeatures;
+
+    initialShape = dlib::mat(reinterpret_cast<const float*>(base + header.initialShapeOffset), shapeSize);
+    anchors = reinterpret_cast<const uint32_t*>(base + header.anchorsOffset);
+    deltas = reinterpret_cast<const float*>(base + header.deltasOffset);
+    splits = reinterpret_cast<const Split*>(base + header.splitsOffset);
+    leaves = reinterpret_cast<const float*>(base + header.leavesOffset);
+}
+
+MappedShapePredictor::~MappedShapePredictor()
+{
+    if (mapping != nullptr) {
+        munmap(mapping, mappingSize);
+    }
+}
+
+void MappedShapePredictor::build(const std::string& modelPath, const std::string& cachePath)
+{
+    // dlib::shape_predictor serialization layout
+    int version = 0;
+    dlib::matrix<float,0,1> initialShape;
+    std::vector<std::vector<dlib::impl::regression_tree>> forests;
+    std::vector<std::vector<unsigned long>> anchorIdx;
+    std::vector<std::vector<dlib::vector<float,2>>> pixelDeltas;
+    dlib::deserialize(modelPath) >> version >> initialShape >> forests >> anchorIdx >> pixelDeltas;
+
+    if (version != 1 || initialShape.size() == 0 || forests.empty() || forests.front().empty() ||
+        anchorIdx.size() != forests.size() || pixelDeltas.size() != forests.size()) {
+        throw std::runtime_error("[KAI Model Store]-- Error: unsupported shape predictor " + modelPath);
+    }
+
+    CacheHeader header = {};
+    std::memcpy(header.magic, cacheMagic, sizeof(cacheMagic));
+    header.shapeSize = static_cast<uint32_t>(initialShape.size());
+    header.numCascades = static_cast<uint32_t>(forests.size());
+    header.numTrees = static_cast<uint32_t>(forests.front().size());
+    header.numSplits = static_cast<uint32_t>(forests.front().front().splits.size());
+    header.numFeatures = static_cast<uint32_t>(anchorIdx.front().size());
+
+    // flat arrays require the same layout in every cascade and tree
+    for (size_t c = 0; c < forests.size(); ++c) {
+        bool uniform = forests[c].size() == header.numTrees && anchorIdx[c].size() == header.numFeatures &&
+                       pixelDeltas[c].size() == header.numFeatures;
+        for (const auto& tree : forests[c]) {
+            uniform = uniform && tree.splits.size() == header.numSplits &&
+                      tree.leaf_values.size() == header.numSplits + 1;
+            for (const auto& split : tree.splits) {
+                uniform = uniform && split.idx1 < header.numFeatures && split.idx2 < header.numFeatures;
+            }
+            for (const auto& leaf : tree.leaf_values) {
+                uniform = uniform && leaf.size() == initialShape.size();
+            }
+        }
+        for (unsigned long anchor : anchorIdx[c]) {
+            uniform = uniform && anchor < header.shapeSize / 2;
+        }
+        if (!uniform) {
+            throw std::runtime_error("[KAI Model Store]-- Error: unsupported shape predictor layout " + modelPath);
+        }
+    }
+
+    struct stat source;
+    if (stat(modelPath.c_str(), &source) == 0) {
+        header.sourceSize = static_cast<uint64_t>(source.st_size);
+        header.sourceMTime = static_cast<int64_t>(source.st_mtim.tv_sec);
+        header.sourceMTimeNsec = static_cast<uint32_t>(source.st_mtim.tv_nsec);
+    }
+
+    const size_t numTreesTotal = static_cast<size_t>(header.numCascades) * header.numTrees;
+    header.initialShapeOffset = alignUp(sizeof(CacheHeader));
+    header.anchorsOffset = alignUp(header.initialShapeOffset + header.shapeSize * sizeof(float));
+    header.deltasOffset = alignUp(header.anchorsOffset + header.numCascades * header.numFeatures * sizeof(uint32_t));
+    header.splitsOffset = alignUp(header.deltasOffset + header.numCascades * header.numFeatures * 2 * sizeof(float));
+    header.leavesOffset = alignUp(header.splitsOffset + numTreesTotal * header.numSplits * sizeof(Split));
+    header.fileSize = header.leavesOffset + numTreesTotal * (header.numSplits + 1) * header.shapeSize * sizeof(float);
+
+    // write + rename: other processes never map a partial file
+    const std::string tmpPath = cachePath + ".tmp" + std::to_string(getpid());
+    {
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+        padTo(out, header.initialShapeOffset);
+        out.write(reinterpret_cast<const char*>(&initialShape(0)), header.shapeSize * sizeof(float));
+
+        padTo(out, header.anchorsOffset);
+        for (const auto& cascadeAnchors : anchorIdx) {
+            for (unsigned long anchor : cascadeAnchors) {
+                const uint32_t value = static_cast<uint32_t>(anchor);
+                out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+            }
+        }
+
+        padTo(out, header.deltasOffset);
+        for (const auto& cascadeDeltas : pixelDeltas) {
+            for (const auto& delta : cascadeDeltas) {
+                const float xy[2] = {delta.x(), delta.y()};
+                out.write(reinterpret_cast<const char*>(xy), sizeof(xy));
+            }
+        }
+
+        padTo(out, header.splitsOffset);
+        for (const auto& forest : forests) {
+            for (const auto& tree : forest) {
+                for (const auto& split : tree.splits) {
+                    const Split value = {static_cast<uint32_t>(split.idx1), static_cast<uint32_t>(split.idx2), split.thresh};
+                    out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+                }
+            }
+        }
+
+        padTo(out, header.leavesOffset);
+        for (const auto& forest : forests) {
+            for (const auto& tree : forest) {
+                for (const auto& leaf : tree.leaf_values) {
+                    out.write(reinterpret_cast<const char*>(&leaf(0)), header.shapeSize * sizeof(float));
+                }
+            }
+        }
+
+        if (!out) {
+            std::remove(tmpPath.c_str());
+            throw std::runtime_error("[KAI Model Store]-- Error: could not write " + tmpPath);
+        }
+    }
+
+    if (std::rename(tmpPath.c_str(), cachePath.c_str()) != 0) {
+        std::remove(tmpPath.c_str());
+        throw std::runtime_error("[KAI Model Store]-- Error: could not write " + cachePath);
+    }
+}
+
+bool MappedShapePredictor::isCurrent(const std::string& cachePath, const std::string& modelPath)
+{
+    CacheHeader header;
+    struct stat source;
+    return readHeader(cachePath, header) && stat(modelPath.c_str(), &source) == 0 &&
+           header.sourceSize == static_cast<uint64_t>(source.st_size) &&
+           header.sourceMTime == static_cast<int64_t>(source.st_mtim.tv_sec) &&
+           header.sourceMTimeNsec == static_cast<uint32_t>(source.st_mtim.tv_nsec);
+}
@@ -0,0 +1,133 @@
+#ifndef MAPPEDSHAPEPREDICTOR_H
+#define MAPPEDSHAPEPREDICTOR_H
+
+#include <dlib/image_processing.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief dlib shape predictor evaluated from a memory-mapped, pre-parsed model file
+ * @note  dlib::shape_predictor deserializes its regression trees (~100 MB for the 68
+ *        landmark model) into per-process heap memory. build() converts a dlib model
+ *        once into a flat file (page-aligned arrays, host byte order), which every
+ *        process maps read-only: the kernel keeps a single physical copy per host.
+ *
+ *        Evaluation follows dlib::shape_predictor::operator() step by step (same
+ *        arithmetic, same order), so the landmarks are identical.
+ *
+ *        MappedShapePredictor::build("shape_predictor_68_face_landmarks.dat", "cache/sp68.kaisp");
+ *        MappedShapePredictor predictor("cache/sp68.kaisp");
+ *        dlib::full_object_detection landmarks = predictor(dlibImage, faceRect);
+ *
+ * @note  Thread safe (read-only after construction).
+ */
+class MappedShapePredictor {
+public:
+    // map <cachePath> (throws std::runtime_error if missing or invalid)
+    explicit MappedShapePredictor(const std::string& cachePath);
+    ~MappedShapePredictor();
+
+    MappedShapePredictor(const MappedShapePredictor&) = delete;
+    MappedShapePredictor& operator=(const MappedShapePredictor&) = delete;
+
+    /**
+     * @brief convert the dlib model <modelPath> to a cache file
+     * @note  written to a temporary file and renamed, so processes building the same
+     *        cache concurrently never map a partial file
+     * @throws std::runtime_error if the model layout is not supported (trees of
+     *         different sizes) or the file cannot be written
+     */
+    static void build(const std::string& modelPath, const std::string& cachePath);
+
+    // true if <cachePath> was built from the current <modelPath> (size and modification time, in ns)
+    static bool isCurrent(const std::string& cachePath, const std::string& modelPath);
+
+    unsigned long num_parts() const {return shapeSize / 2;}
+
+    template <typename image_type>
+    dlib::full_object_detection operator()(const image_type& img, const dlib::rectangle& rect) const
+    {
+        dlib::matrix<float,0,1> currentShape = initialShape;
+        std::vector<float> featurePixelValues(numFeatures);
+
+        for (uint32_t cascade = 0; cascade < numCascades; ++cascade) {
+            extractFeaturePixelValues(img, rect, currentShape, cascade, featurePixelValues);
+
+            // evaluate all the trees at this level of the cascade
+            for (uint32_t tree = 0; tree < numTrees; ++tree) {
+                const Split* treeSplits = splits + (static_cast<size_t>(cascade) * numTrees + tree) * numSplits;
+
+                uint32_t i = 0;
+                while (i < numSplits) {
+                    const Split& split = treeSplits[i];
+                    i = (featurePixelValues[split.idx1] - featurePixelValues[split.idx2] > split.thresh)
+                        ? 2 * i + 1 : 2 * i + 2;
+                }
+
+                const float* leaf = leaves + ((static_cast<size_t>(cascade) * numTrees + tree) * (numSplits + 1) +
+                                              (i - numSplits)) * shapeSize;
+                currentShape += dlib::mat(leaf, shapeSize);
+            }
+        }
+
+        // convert the current shape into a full_object_detection
+        const dlib::point_transform_affine tformToImg = dlib::impl::unnormalizing_tform(rect);
+        std::vector<dlib::point> parts(shapeSize / 2);
+        for (size_t i = 0; i < parts.size(); ++i) {
+            parts[i] = tformToImg(dlib::impl::location(currentShape, i));
+        }
+        return dlib::full_object_detection(rect, parts);
+    }
+
+private:
+    struct Split {
+        uint32_t idx1;
+        uint32_t idx2;
+        float thresh;
+    };
+
+    template <typename image_type>
+    void extractFeaturePixelValues(const image_type& img_, const dlib::rectangle& rect,
+                                   const dlib::matrix<float,0,1>& currentShape, uint32_t cascade,
+                                   std::vector<float>& featurePixelValues) const
+    {
+        const dlib::matrix<float,2,2> tform = dlib::matrix_cast<float>(
+            dlib::impl::find_tform_between_shapes(initialShape, currentShape).get_m());
+        const dlib::point_transform_affine tformToImg = dlib::impl::unnormalizing_tform(rect);
+
+        const dlib::rectangle area = dlib::get_rect(img_);
+        dlib::const_image_view<image_type> img(img_);
+
+        const uint32_t* cascadeAnchors = anchors + static_cast<size_t>(cascade) * numFeatures;
+        const float* cascadeDeltas = deltas + static_cast<size_t>(cascade) * numFeatures * 2;
+        for (uint32_t i = 0; i < numFeatures; ++i) {
+            // pixel relative to the current shape, mapped from the normalized shape space to the image
+            const dlib::vector<float,2> delta(cascadeDeltas[2 * i], cascadeDeltas[2 * i + 1]);
+            dlib::point p = tformToImg(tform * delta + dlib::impl::location(currentShape, cascadeAnchors[i]));
+            featurePixelValues[i] = area.contains(p) ? dlib::get_pixel_intensity(img[p.y()][p.x()]) : 0;
+        }
+    }
+
+    // mapping
+    void* mapping = nullptr;
+    size_t mappingSize = 0;
+
+    // model layout (all cascades: numTrees trees of numSplits splits, numFeatures pixels)
+    uint32_t shapeSize = 0;   // 2 x parts
+    uint32_t numCascades = 0;
+    uint32_t numTrees = 0;
+    uint32_t numSplits = 0;
+    uint32_t numFeatures = 0;
+
+    dlib::matrix<float,0,1> initialShape;
+
+    // arrays in the mapping
+    const uint32_t* anchors = nullptr; // [cascade][feature]
+    const float* deltas = nullptr;     // [cascade][feature][x, y]
+    const Split* splits = nullptr;     // [cascade][tree][split]
+    const float* leaves = nullptr;     // [cascade][tree][leaf][shapeSize]
+};
+#endif // MAPPEDSHAPEPREDICTOR_H
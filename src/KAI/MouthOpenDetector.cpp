@@ -28,6 +28,8 @@ MouthOpenDetector::MouthOpenDetector(const std::string& modelPath,
    
     mouthOpenNet_.setPreferableBackend(backendId);
     mouthOpenNet_.setPreferableTarget(targetId);
+
+    setupPreprocessor();
 }
 
 void MouthOpenDetector::init(const std::map<std::string, Type> params)
@@ -55,48 +57,78 @@ void MouthOpenDetector::init(const std::map<std::string, Type> params)
     if (params.find("NNInputName") != params.end()) {
         inputName = params.at("NNInputName").get<std::string>();
     }
+
+    setupPreprocessor();
+}
+
+void MouthOpenDetector::setupPreprocessor()
+{
+    ImagePreprocessor::Params preParams;
+    preParams.outSize = net_inputSize;
+    preParams.keepAspectRatio = false; // face crop is stretched to the input size
+    preParams.mean = cv::Scalar(0, 0, 0);
+    preParams.scale = scaleFactor;
+    preParams.swapRB = swapRB;
+    preParams.layout = ImagePreprocessor::NCHW;
+
+    preprocessor.setParams(preParams);
+
+    // network input blob (reused for all faces and images)
+    const int blobShape[] = {1, 3, net_inputSize.height, net_inputSize.width};
+    inputBlob.create(4, blobShape, CV_32F);
 }
 
 void MouthOpenDetector::run(Image &img)
 {
-    cv::Mat imgMat;
-    img.getImage_Mat(imgMat);
-    
-    // original image width and height
-    int imgWidth = imgMat.cols;
-    int imgHeight = imgMat.rows;
-
-    // TODO: update facial features class on Image
-    auto vFFeatures = img.getFacialFeatures();
-    
+    // face records are updated in place
+    auto& vFFeatures = img.getFacialFeaturesRef();
+
     // Loop through detected face bounding boxes
     for (auto& fFeatures : vFFeatures) {
 
+        // stop early (partial results) once the deadline has passed
+        if (img.isBudgetExhausted()) {
+            img.markPartial(getName());
+            break;
+        }
+
         auto faceBox = fFeatures.getFaceBbox();
 
-        // crop face bbox and resize to model's input size
-        cv::Mat faceMat = imgMat(faceBox);
-        cv::resize(faceMat, faceMat, net_inputSize);
+        // crop face bbox, resize to model's input size and normalize
+        // (single pass, straight into the network's input blob)
+        preprocessor.run(img.getImage_Region(faceBox), inputBlob.ptr<float>());
         
-        cv::Mat blob = cv::dnn::blobFromImage(faceMat, scaleFactor, net_inputSize,
-                                              cv::Scalar(0, 0, 0), swapRB, crop);
-        
-        mouthOpenNet_.setInput(blob, inputName);
+        mouthOpenNet_.setInput(inputBlob, inputName);
         // output: prob. of mouth open
         float probMouthOpen = mouthOpenNet_.forward().at<float>(0,0);
 
-        auto pMouthOpen = std::make_shared<MouthOpen>();
-        pMouthOpen->openScore = probMouthOpen;
+        MouthOpen mouthOpen;
+        mouthOpen.openScore = probMouthOpen;
 
-        // compute mouth open ratio
-        // (done in FacialFeatures Class, when MouthOpen aux data requested)
-        // TODO/NOTE: currently, mouthOpenRatio is never computed and stored in AuxData.
-        //            (computed only when getMouthOpenRatio is called in FacialFeatures class)
+        // Note: mouth open ratio is computed from the feature points on request
+        //       (FacialFeatures::getMouthOpenRatio), it is not stored in AuxData.
 
         // Update Aux Data in Facial Features class
-        fFeatures.setAuxData<MouthOpen>(pMouthOpen);
+        fFeatures.setAuxData(mouthOpen);
     }
+}
 
-    // TODO: Image class should modify its facial features in-place (instead of clear and copy)
-    img.setFacialFeatures(vFFeatures);
-}
\ No newline at end of file
+std::vector<KAIExecConfig> MouthOpenDetector::getExecCandidates() const
+{
+    return getDnnExecCandidates();
+}
+
+void MouthOpenDetector::setExecConfig(const KAIExecConfig& config)
+{
+    mouthOpenNet_.setPreferableBackend(config.backendId);
+    mouthOpenNet_.setPreferableTarget(config.targetId);
+}
+
+void MouthOpenDetector::runSynthetic(int /*batchSize*/)
+{
+    // one face crop (faces are processed one at a time)
+    inputBlob.setTo(cv::Scalar(0));
+
+    mouthOpenNet_.setInput(inputBlob, inputName);
+    mouthOpenNet_.forward();
+}
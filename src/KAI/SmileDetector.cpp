@@ -28,6 +28,8 @@ SmileDetector::SmileDetector(const std::string& modelPath,
    
     smileNet_.setPreferableBackend(backendId);
     smileNet_.setPreferableTarget(targetId);
+
+    setupPreprocessor();
 }
 
 void SmileDetector::init(const std::map<std::string, Type> params)
@@ -55,43 +57,75 @@ void SmileDetector::init(const std::map<std::string, Type> params)
     if (params.find("NNInputName") != params.end()) {
         inputName = params.at("NNInputName").get<std::string>();
     }
+
+    setupPreprocessor();
+}
+
+void SmileDetector::setupPreprocessor()
+{
+    ImagePreprocessor::Params preParams;
+    preParams.outSize = net_inputSize;
+    preParams.keepAspectRatio = false; // face crop is stretched to the input size
+    preParams.mean = cv::Scalar(0, 0, 0);
+    preParams.scale = scaleFactor;
+    preParams.swapRB = swapRB;
+    preParams.layout = ImagePreprocessor::NCHW;
+
+    preprocessor.setParams(preParams);
+
+    // network input blob (reused for all faces and images)
+    const int blobShape[] = {1, 3, net_inputSize.height, net_inputSize.width};
+    inputBlob.create(4, blobShape, CV_32F);
 }
 
 void SmileDetector::run(Image &img)
 {
-    cv::Mat imgMat;
-    img.getImage_Mat(imgMat);
-    
-    // original image width and height
-    int imgWidth = imgMat.cols;
-    int imgHeight = imgMat.rows;
-
-    // TODO: update facial features class on Image
-    auto vFFeatures = img.getFacialFeatures();
-    
+    // face records are updated in place
+    auto& vFFeatures = img.getFacialFeaturesRef();
+
     // Loop through detected face bounding boxes
     for (auto& fFeatures : vFFeatures) {
 
-        auto faceBox = fFeatures.getFaceBbox();
+        // stop early (partial results) once the deadline has passed
+        if (img.isBudgetExhausted()) {
+            img.markPartial(getName());
+            break;
+        }
 
-        // crop face bbox and resize to model's input size
-        cv::Mat faceMat = imgMat(faceBox);
-        cv::resize(faceMat, faceMat, net_inputSize);
+        auto faceBox = fFeatures.getFaceBbox();
 
-        cv::Mat blob = cv::dnn::blobFromImage(faceMat, scaleFactor, net_inputSize,
-                                              cv::Scalar(0, 0, 0), swapRB, crop);
+        // crop face bbox, resize to model's input size and normalize
+        // (single pass, straight into the network's input blob)
+        preprocessor.run(img.getImage_Region(faceBox), inputBlob.ptr<float>());
         
-        smileNet_.setInput(blob, inputName);
+        smileNet_.setInput(inputBlob, inputName);
         // output: prob. of mouth open
         float probSmile = smileNet_.forward().at<float>(0,0);
 
-        auto pSmile = std::make_shared<Smile>();
-        pSmile->smileScore = probSmile;
+        Smile smile;
+        smile.smileScore = probSmile;
 
         // Update Aux Data in Facial Features class
-        fFeatures.setAuxData<Smile>(pSmile);
+        fFeatures.setAuxData(smile);
     }
+}
 
-    // TODO: Image class should modify its facial features in-place (instead of clear and copy)
-    img.setFacialFeatures(vFFeatures);
-}
\ No newline at end of file
+std::vector<KAIExecConfig> SmileDetector::getExecCandidates() const
+{
+    return getDnnExecCandidates();
+}
+
+void SmileDetector::setExecConfig(const KAIExecConfig& config)
+{
+    smileNet_.setPreferableBackend(config.backendId);
+    smileNet_.setPreferableTarget(config.targetId);
+}
+
+void SmileDetector::runSynthetic(int /*batchSize*/)
+{
+    // one face crop (faces are processed one at a time)
+    inputBlob.setTo(cv::Scalar(0));
+
+    smileNet_.setInput(inputBlob, inputName);
+    smileNet_.forward();
+}
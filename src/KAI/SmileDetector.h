@@ -2,6 +2,7 @@
 #define SMILEDETECTOR_H
 
 #include "KAITaskInterface.h"
+#include "ImagePreprocessor.h"
 #include "FacialFeatures.h"
 #include "Types.h"
 
@@ -18,6 +19,11 @@ public:
 
     void run(Image& img) override;
 
+    // auto-tuner: cv::dnn backends on the CPU
+    std::vector<KAIExecConfig> getExecCandidates() const override;
+    void setExecConfig(const KAIExecConfig& config) override;
+    void runSynthetic(int batchSize) override;
+
 private:
     cv::dnn::Net smileNet_;
 
@@ -31,6 +37,15 @@ private:
 
     bool swapRB = false;
     bool crop = false;
+
+    // fused preprocessing (crop + resize + normalization -> input blob)
+    ImagePreprocessor preprocessor;
+
+    // network input blob [1 x 3 x H x W] (reused for all faces and images)
+    cv::Mat inputBlob;
+
+    // update preprocessor with the current network params
+    void setupPreprocessor();
     
     ///
     // helper functions
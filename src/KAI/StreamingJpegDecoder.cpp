@@ -0,0 +1,249 @@
+#include "StreamingJpegDecoder.h"
+
+#include <opencv2/imgproc.hpp>
+
+#include <algorithm>
+#include <csetjmp>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+
+// libjpeg: system copy, or the one compiled into dlib (dlib/external/libjpeg)
+#ifdef KAI_JPEG_STATIC
+#   include "dlib/external/libjpeg/jpeglib.h"
+#else
+#   include <jpeglib.h>
+#endif
+
+namespace {
+    // libjpeg reports fatal errors through error_exit (must not return)
+    struct JpegErrorManager {
+        jpeg_error_mgr pub;
+        jmp_buf jump;
+        char message[JMSG_LENGTH_MAX];
+    };
+
+    void jpegErrorExit(j_common_ptr cinfo) {
+        JpegErrorManager* err = reinterpret_cast<JpegErrorManager*>(cinfo->err);
+        (*cinfo->err->format_message)(cinfo, err->message);
+        longjmp(err->jump, 1);
+    }
+}
+
+StreamingJpegDecoder::StreamingJpegDecoder(const std::string& path)
+    : filePath(path)
+{
+    if (!decodePass(1, nullptr, fullSize)) {
+        throw std::runtime_error("Streaming JPEG Decoder -- Error reading " + path + ": " + lastError);
+    }
+}
+
+StreamingJpegDecoder::StreamingJpegDecoder(std::vector<uchar> bytes)
+    : buffer(std::move(bytes))
+{
+    if (!decodePass(1, nullptr, fullSize)) {
+        throw std::runtime_error("Streaming JPEG Decoder -- Error reading the image header: " + lastError);
+    }
+}
+
+bool StreamingJpegDecoder::isJpeg(const uchar* data, size_t size)
+{
+    return data != nullptr && size >= 3 && data[0] == 0xFF && data[1] == 0xD8 && data[2] == 0xFF;
+}
+
+bool StreamingJpegDecoder::isJpeg(const std::string& path)
+{
+    uchar signature[3] = {0, 0, 0};
+    std::ifstream file(path, std::ios::binary);
+    file.read(reinterpret_cast<char*>(signature), sizeof(signature));
+    return file && isJpeg(signature, sizeof(signature));
+}
+
+cv::Mat StreamingJpegDecoder::decodePreview(int minLongSide, float& scale)
+{
+    if (progressive) {
+        throw std::runtime_error("Streaming JPEG Decoder -- Error: progressive JPEGs cannot be decoded in strips");
+    }
+
+    // largest DCT scale (1/8, 1/4, 1/2, 1) that keeps the long side >= minLongSide
+    const int longSide = std::max(fullSize.width, fullSize.height);
+    int scaleDenom = 8;
+    while (scaleDenom > 1 && (longSide + scaleDenom - 1) / scaleDenom < minLongSide) {
+        scaleDenom /= 2;
+    }
+
+    cv::Size previewSize;
+    if (!decodePass(scaleDenom, nullptr, previewSize)) {
+        throw std::runtime_error("Streaming JPEG Decoder -- Error: " + lastError);
+    }
+
+    // strips are converted to BGR as they are decoded
+    cv::Mat preview(previewSize, CV_8UC3);
+    StripHandler toPreview = [&preview](const uchar* rows, int firstRow, int numRows,
+                                        int width, size_t rowBytes) {
+        cv::Mat strip(numRows, width, CV_8UC3, const_cast<uchar*>(rows), rowBytes);
+        cv::Mat previewRows = preview.rowRange(firstRow, firstRow + numRows);
+        cv::cvtColor(strip, previewRows, cv::COLOR_RGB2BGR);
+        return true;
+    };
+
+    if (!decodePass(scaleDenom, &toPreview, previewSize)) {
+        throw std::runtime_error("Streaming JPEG Decoder -- Error: " + lastError);
+    }
+
+    scale = static_cast<float>(previewSize.width) / fullSize.width;
+    return preview;
+}
+
+std::vector<cv::Mat> StreamingJpegDecoder::decodeRegions(const std::vector<cv::Rect>& regions)
+{
+    if (progressive) {
+        throw std::runtime_error("Streaming JPEG Decoder -- Error: progressive JPEGs cannot be decoded in strips");
+    }
+
+    const cv::Rect frame(cv::Point(0, 0), fullSize);
+
+    std::vector<cv::Rect> boxes;
+    std::vector<cv::Mat> outputs;
+    int lastRow = 0;
+    for (const auto& region : regions) {
+        cv::Rect box = region & frame;
+        boxes.push_back(box);
+        outputs.push_back(cv::Mat(box.size(), CV_8UC3));
+        lastRow = std::max(lastRow, box.br().y);
+    }
+
+    if (lastRow == 0) {
+        return outputs;
+    }
+
+    // copy the RGB rows/cols of each region, stop after the last region
+    StripHandler toRegions = [&](const uchar* rows, int firstRow, int numRows,
+                                 int /*width*/, size_t rowBytes) {
+        for (size_t i = 0; i < boxes.size(); ++i) {
+            const cv::Rect& box = boxes[i];
+            const int y0 = std::max(box.y, firstRow);
+            const int y1 = std::min(box.br().y, firstRow + numRows);
+            for (int y = y0; y < y1; ++y) {
+                const uchar* src = rows + static_cast<size_t>(y - firstRow) * rowBytes + box.x * 3;
+                std::copy(src, src + box.width * 3, outputs[i].ptr<uchar>(y - box.y));
+            }
+        }
+        return firstRow + numRows < lastRow;
+    };
+
+    cv::Size outSize;
+    if (!decodePass(1, &toRegions, outSize)) {
+        throw std::runtime_error("Streaming JPEG Decoder -- Error: " + lastError);
+    }
+
+    for (auto& output : outputs) {
+        if (!output.empty()) {
+            cv::cvtColor(output, output, cv::COLOR_RGB2BGR);
+        }
+    }
+    return outputs;
+}
+
+// Note: libjpeg errors longjmp back into this function,
+//       so it only holds trivially destructible locals
+bool StreamingJpegDecoder::decodePass(int scaleDenom, const StripHandler* onStrip, cv::Size& outSize)
+{
+    jpeg_decompress_struct cinfo;
+    JpegErrorManager jerr;
+    FILE* volatile file = nullptr; // modified after setjmp
+
+    cinfo.err = jpeg_std_error(&jerr.pub);
+    jerr.pub.error_exit = jpegErrorExit;
+
+    if (setjmp(jerr.jump)) {
+        jpeg_destroy_decompress(&cinfo);
+        if (file != nullptr) {
+            fclose(file);
+        }
+        lastError = jerr.message;
+        return false;
+    }
+
+    jpeg_create_decompress(&cinfo);
+
+    if (!filePath.empty()) {
+        file = fopen(filePath.c_str(), "rb");
+        if (file == nullptr) {
+            jpeg_destroy_decompress(&cinfo);
+            lastError = "could not open " + filePath;
+            return false;
+        }
+        jpeg_stdio_src(&cinfo, file);
+    }
+    else {
+        jpeg_mem_src(&cinfo, buffer.data(), static_cast<unsigned long>(buffer.size()));
+    }
+
+    jpeg_read_header(&cinfo, TRUE);
+
+    // progressive: jpeg_start_decompress would buffer the coefficients of the whole image
+    progressive = (cinfo.progressive_mode != FALSE);
+
+    // grayscale and YCbCr are converted to RGB by libjpeg
+    cinfo.out_color_space = JCS_RGB;
+    cinfo.scale_num = 1;
+    cinfo.scale_denom = static_cast<unsigned int>(scaleDenom);
+    jpeg_calc_output_dimensions(&cinfo);
+
+    outSize = cv::Size(static_cast<int>(cinfo.output_width), static_cast<int>(cinfo.output_height));
+
+    // header only
+    if (onStrip == nullptr) {
+        jpeg_destroy_decompress(&cinfo);
+        if (file != nullptr) {
+            fclose(file);
+        }
+        return true;
+    }
+
+    jpeg_start_decompress(&cinfo);
+
+    const size_t rowBytes = static_cast<size_t>(cinfo.output_width) * cinfo.output_components;
+    stripBuffer.resize(rowBytes * stripRows);
+    rowPointers.resize(stripRows);
+    for (int i = 0; i < stripRows; ++i) {
+        rowPointers[i] = stripBuffer.data() + i * rowBytes;
+    }
+
+    bool more = true;
+    while (more && cinfo.output_scanline < cinfo.output_height) {
+        const int firstRow = static_cast<int>(cinfo.output_scanline);
+        int numRows = 0;
+        while (numRows < stripRows && cinfo.output_scanline < cinfo.output_height) {
+            numRows += static_cast<int>(jpeg_read_scanlines(&cinfo, &rowPointers[numRows],
+                                                            static_cast<JDIMENSION>(stripRows - numRows)));
+        }
+
+        try {
+            more = (*onStrip)(stripBuffer.data(), firstRow, numRows,
+                              static_cast<int>(cinfo.output_width), rowBytes);
+        }
+        catch (...) {
+            jpeg_destroy_decompress(&cinfo);
+            if (file != nullptr) {
+                fclose(file);
+            }
+            throw;
+        }
+    }
+
+    // remaining scanlines are not needed
+    if (cinfo.output_scanline < cinfo.output_height) {
+        jpeg_abort_decompress(&cinfo);
+    }
+    else {
+        jpeg_finish_decompress(&cinfo);
+    }
+
+    jpeg_destroy_decompress(&cinfo);
+    if (file != nullptr) {
+        fclose(file);
+    }
+    return true;
+}
@@ -0,0 +1,91 @@
+#ifndef STREAMINGJPEGDECODER_H
+#define STREAMINGJPEGDECODER_H
+
+#include <opencv2/core.hpp>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Strip-wise (scanline) JPEG decoding for very large images
+ * @note  The full-resolution frame is never held in memory:
+ *        1. decodePreview: downscaled frame for face detection, decoded with libjpeg's DCT
+ *           scaling (1/2, 1/4, 1/8) and written strip by strip.
+ *        2. decodeRegions: full-resolution decode in strips, keeping only the rows/cols
+ *           of the requested regions (e.g., margin-padded face boxes); decoding stops
+ *           after the last region.
+ *        Peak memory: preview + one strip + regions.
+ *
+ * @note  Baseline (sequential) JPEGs only: libjpeg buffers the DCT coefficients of the
+ *        whole image for progressive JPEGs, so their memory grows with the total pixels.
+ *        Callers check isProgressive() and decode those as a whole (decodePreview and
+ *        decodeRegions throw for them).
+ *
+ * @note  Each call is an independent decoding pass over the (file or memory) source.
+ *        Output images are 8-bit BGR.
+ */
+class StreamingJpegDecoder {
+public:
+    // decode from a file
+    explicit StreamingJpegDecoder(const std::string& path);
+
+    // decode from encoded bytes held in memory
+    explicit StreamingJpegDecoder(std::vector<uchar> bytes);
+
+    // full-resolution image size (from the JPEG header)
+    cv::Size getSize() const {return fullSize;}
+
+    // progressive JPEG (cannot be decoded in strips, see above)
+    bool isProgressive() const {return progressive;}
+
+    // encoded bytes of a memory source, handed back (e.g., to decode a progressive JPEG as a whole)
+    std::vector<uchar> takeBytes() {return std::move(buffer);}
+
+    // JPEG signature (SOI marker)
+    static bool isJpeg(const uchar* data, size_t size);
+    static bool isJpeg(const std::string& path);
+
+    /**
+     * @brief downscaled frame (largest DCT scale whose long side is >= minLongSide)
+     * @param scale - preview size / full-resolution size
+     */
+    cv::Mat decodePreview(int minLongSide, float& scale);
+
+    // full-resolution pixels of <regions> (clipped to the image), in the same order
+    std::vector<cv::Mat> decodeRegions(const std::vector<cv::Rect>& regions);
+
+    // scanlines decoded per strip
+    void setStripRows(int rows) {stripRows = std::max(1, rows);}
+
+private:
+    std::string filePath;
+    std::vector<uchar> buffer; // encoded bytes (memory source)
+
+    cv::Size fullSize;
+    bool progressive = false;
+    int stripRows = 64;
+
+    // strip scratch buffer (RGB, reused across passes)
+    std::vector<uchar> stripBuffer;
+
+    // receives <numRows> RGB rows starting at output row <firstRow>
+    // returns false to stop decoding
+    using StripHandler = std::function<bool(const uchar* rows, int firstRow, int numRows,
+                                            int width, size_t rowBytes)>;
+
+    // row pointers into stripBuffer
+    std::vector<uchar*> rowPointers;
+
+    // libjpeg error of the last pass
+    std::string lastError;
+
+    /**
+     * @brief one decoding pass at 1/<scaleDenom> resolution
+     * @param outSize - output image size at that scale
+     * @note  <onStrip> == nullptr: reads the header only
+     * @return false on a libjpeg error (see lastError)
+     */
+    bool decodePass(int scaleDenom, const StripHandler* onStrip, cv::Size& outSize);
+};
+#endif // STREAMINGJPEGDECODER_H
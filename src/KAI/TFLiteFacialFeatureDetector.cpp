@@ -1,6 +1,9 @@
 #include "TFLiteFacialFeatureDetector.h"
+#include "KAIModelStore.h"
 
 #include <iostream>
+#include <algorithm>
+#include <thread>
 
 // helper function to clip scaled boxes to image dims
 auto clip = [](float n, float lower, float upper) {
@@ -9,30 +12,18 @@ auto clip = [](float n, float lower, float upper) {
 
 TFLiteFacialFeatureDetector::TFLiteFacialFeatureDetector(const std::string& modelPath) {
     
-    // Load the TFLite model
-    faceMeshNet_ = tflite::FlatBufferModel::BuildFromFile(modelPath.c_str());
+    // Load the TFLite model (shared by the interpreters of all pipelines)
+    faceMeshNet_ = KAIModelStore::getInstance().getTFLiteModel(modelPath);
     if(faceMeshNet_ == nullptr){
         throw std::runtime_error("Facial Features Detection Task"
                 "-- Error loading the TFLite model.");
     }
     
-    // Build the interpreter with the InterpreterBuilder.
-    tflite::ops::builtin::BuiltinOpResolver resolver;
-    tflite::InterpreterBuilder builder(*faceMeshNet_.get(), resolver);
-    builder(&interpreter);
-    if (interpreter == nullptr){
-        throw std::runtime_error("Facial Features Detection Task"
-                "-- Failed to build the TFLite model interpreter.");
-    }
+    // Build the interpreter with default settings
+    // (rebuilt in init() if threading or delegate params are provided)
+    buildInterpreter();
 
-    // Allocate tensor buffers.
-    if (interpreter->AllocateTensors() != kTfLiteOk){
-        throw std::runtime_error("Facial Features Detection Task"
-                "-- Failed to allocate tensors for the TFLite model interpreter.");
-    }
-    
-    // TODO: set num threads for the interpreter
-    // interpreter->SetNumThreads(numThreads);
+    setupPreprocessor();
 }
 
 void TFLiteFacialFeatureDetector::init(const std::map<std::string, Type> params){
@@ -47,67 +38,358 @@ void TFLiteFacialFeatureDetector::init(const std::map<std::string, Type> params)
 
         net_inputSize = cv::Size(imgWidth, imgHeight);
     }
+
+    // interpreter threads
+    bool rebuild = false;
+    if (params.find("NumThreads") != params.end()) {
+        numThreads = params.at("NumThreads").get<int>();
+        numThreadsFromParams = true;
+        rebuild = true;
+    }
+
+    // XNNPACK delegate
+    if (params.find("UseXNNPACK") != params.end()) {
+        useXNNPACK = params.at("UseXNNPACK").get<int>() != 0;
+        useXNNPACKFromParams = true;
+        rebuild = true;
+    }
+
+    // max. number of faces to run in a single Invoke
+    if (params.find("BatchFaces") != params.end()) {
+        maxBatchSize = std::max(1, params.at("BatchFaces").get<int>());
+        batchSizeFromParams = true;
+    }
+
+    // all batch sizes are built here (also without warm-up): the first group photo
+    // does not pay for them, and a size the model rejects disables batching at load time
+    if (rebuild) {
+        buildInterpreter();
+    }
+    else {
+        buildBatchInterpreters();
+    }
+
+    setupPreprocessor();
+}
+
+void TFLiteFacialFeatureDetector::setIntraOpThreads(int threads) {
+    if (numThreadsFromParams || threads == numThreads) {
+        return;
+    }
+
+    numThreads = threads;
+    buildInterpreter();
+}
+
+std::vector<KAIExecConfig> TFLiteFacialFeatureDetector::getExecCandidates() const {
+
+    std::vector<KAIEngine> engines = {useXNNPACK ? KAIEngine::TFLiteXNNPACK : KAIEngine::TFLite};
+#ifdef KAI_TFLITE_XNNPACK
+    if (!useXNNPACKFromParams) {
+        engines = {KAIEngine::TFLite, KAIEngine::TFLiteXNNPACK};
+    }
+#endif
+
+    // powers of two up to the threads allowed by the threading policy
+    const int maxThreads = numThreads > 0 ? numThreads
+                                          : std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    std::vector<int> threads = {maxThreads};
+    if (!numThreadsFromParams) {
+        threads.clear();
+        for (int n = 1; n < maxThreads; n *= 2) {
+            threads.push_back(n);
+        }
+        threads.push_back(maxThreads);
+    }
+
+    std::vector<int> batchSizes = {maxBatchSize};
+    if (!batchSizeFromParams) {
+        batchSizes = {1, 4, 8};
+    }
+
+    std::vector<KAIExecConfig> candidates;
+    for (KAIEngine engine : engines) {
+        for (int n : threads) {
+            for (int batch : batchSizes) {
+                KAIExecConfig config;
+                config.engine = engine;
+                config.numThreads = n;
+                config.batchSize = batch;
+                candidates.push_back(config);
+            }
+        }
+    }
+    return candidates;
+}
+
+void TFLiteFacialFeatureDetector::setExecConfig(const KAIExecConfig& config) {
+
+    const bool xnnpack = (config.engine == KAIEngine::TFLiteXNNPACK);
+    const int threads = config.numThreads > 0 ? config.numThreads : numThreads;
+    maxBatchSize = std::max(1, config.batchSize);
+
+    if (xnnpack == useXNNPACK && threads == numThreads) {
+        dropUnusedInterpreters();
+        buildBatchInterpreters();
+        return;
+    }
+
+    useXNNPACK = xnnpack;
+    numThreads = threads;
+    buildInterpreter();
+}
+
+void TFLiteFacialFeatureDetector::runSynthetic(int batchSize) {
+
+    tflite::Interpreter& interpreter = getInterpreter(getBatchSize(std::max(1, batchSize)));
+
+    faceMeshNet_inputLayer = interpreter.typed_input_tensor<float>(0);
+    std::fill(faceMeshNet_inputLayer, faceMeshNet_inputLayer + interpreter.input_tensor(0)->bytes / sizeof(float), 0.0f);
+
+    if (interpreter.Invoke() != kTfLiteOk){
+        throw std::runtime_error("Facial Features Detection Task"
+                "-- Failed to invoke the TFLite model interpreter.");
+    }
+}
+
+void TFLiteFacialFeatureDetector::warmUp(int runs) {
+    for (int i = 0; i < runs; ++i) {
+        if (maxBatchSize > 1) {
+            // not every model accepts batch > 1: fall back to one face per Invoke
+            try {
+                for (int batch = 2; batch < maxBatchSize; batch *= 2) {
+                    runSynthetic(batch);
+                }
+                runSynthetic(maxBatchSize);
+            }
+            catch (const std::exception& e) {
+                disableBatching(e);
+            }
+        }
+        runSynthetic(1);
+    }
+}
+
+void TFLiteFacialFeatureDetector::disableBatching(const std::exception& e) {
+    std::cerr << "Facial Features Detection Task -- " << e.what()
+              << " (BatchFaces " << maxBatchSize << " not supported by the model, using 1)" << std::endl;
+    maxBatchSize = 1;
+    dropUnusedInterpreters();
+}
+
+void TFLiteFacialFeatureDetector::dropUnusedInterpreters() {
+    interpreters.erase(std::remove_if(interpreters.begin(), interpreters.end(),
+                                      [this](const std::unique_ptr<BatchInterpreter>& batchInterpreter) {
+                                          return batchInterpreter->batchSize > maxBatchSize;
+                                      }),
+                       interpreters.end());
+}
+
+void TFLiteFacialFeatureDetector::setupPreprocessor() {
+    
+    // normalized between (-1, 1)
+    float inputNorm_mean =  127.5f;
+    float inputNorm_std  =  127.5f;
+
+    ImagePreprocessor::Params preParams;
+    preParams.outSize = net_inputSize;
+    preParams.keepAspectRatio = true; // padded resize
+    preParams.padValue = cv::Scalar(114, 114, 114);
+    preParams.mean = cv::Scalar(inputNorm_mean, inputNorm_mean, inputNorm_mean);
+    preParams.scale = 1 / inputNorm_std;
+    preParams.swapRB = true;          // model expects RGB
+    preParams.layout = ImagePreprocessor::NHWC;
+
+    preprocessor.setParams(preParams);
+}
+
+void TFLiteFacialFeatureDetector::buildInterpreter() {
+
+    // interpreters are released before their delegates (member order)
+    interpreters.clear();
+    getInterpreter(1);
+    buildBatchInterpreters();
+}
+
+void TFLiteFacialFeatureDetector::buildBatchInterpreters() {
+    if (maxBatchSize <= 1) {
+        return;
+    }
+
+    // not every model accepts batch > 1: fall back to one face per Invoke
+    try {
+        for (int batch = 2; batch < maxBatchSize; batch *= 2) {
+            getInterpreter(batch);
+        }
+        getInterpreter(maxBatchSize);
+    }
+    catch (const std::exception& e) {
+        disableBatching(e);
+    }
+}
+
+tflite::Interpreter& TFLiteFacialFeatureDetector::getInterpreter(int batch) {
+
+    for (const auto& batchInterpreter : interpreters) {
+        if (batchInterpreter->batchSize == batch) {
+            return *batchInterpreter->interpreter;
+        }
+    }
+
+    std::unique_ptr<BatchInterpreter> batchInterpreter(new BatchInterpreter);
+    batchInterpreter->batchSize = batch;
+    std::unique_ptr<tflite::Interpreter>& interpreter = batchInterpreter->interpreter;
+
+    // Build the interpreter with the InterpreterBuilder.
+    tflite::ops::builtin::BuiltinOpResolver resolver;
+    tflite::InterpreterBuilder builder(*faceMeshNet_, resolver);
+    builder(&interpreter);
+    if (interpreter == nullptr){
+        throw std::runtime_error("Facial Features Detection Task"
+                "-- Failed to build the TFLite model interpreter.");
+    }
+
+    // set num threads for the interpreter
+    // (must be set before applying delegates)
+    interpreter->SetNumThreads(numThreads);
+
+    // input shape: [batch, height, width, 3] (NHWC); the model is built with batch size 1
+    if (batch > 1) {
+        std::vector<int> inputShape = {batch, net_inputSize.height, net_inputSize.width, 3};
+        if (interpreter->ResizeInputTensor(interpreter->inputs()[0], inputShape) != kTfLiteOk){
+            throw std::runtime_error("Facial Features Detection Task"
+                    "-- Failed to resize the TFLite input tensor to batch size " + std::to_string(batch));
+        }
+    }
+
+    if (useXNNPACK) {
+#ifdef KAI_TFLITE_XNNPACK
+        TfLiteXNNPackDelegateOptions xnnpackOptions = TfLiteXNNPackDelegateOptionsDefault();
+        xnnpackOptions.num_threads = std::max(1, numThreads);
+
+        batchInterpreter->xnnpackDelegate.reset(TfLiteXNNPackDelegateCreate(&xnnpackOptions));
+        if (interpreter->ModifyGraphWithDelegate(batchInterpreter->xnnpackDelegate.get()) != kTfLiteOk){
+            throw std::runtime_error("Facial Features Detection Task"
+                    "-- Failed to apply the XNNPACK delegate.");
+        }
+#else
+        std::cerr << "Facial Features Detection Task -- "
+                     "XNNPACK delegate is not available in this build (UseXNNPACK ignored)." << std::endl;
+#endif
+    }
+
+    // Allocate tensor buffers.
+    if (interpreter->AllocateTensors() != kTfLiteOk){
+        throw std::runtime_error("Facial Features Detection Task"
+                "-- Failed to allocate tensors for the TFLite model interpreter (batch size " +
+                std::to_string(batch) + ")");
+    }
+
+    interpreters.push_back(std::move(batchInterpreter));
+    return *interpreters.back()->interpreter;
+}
+
+int TFLiteFacialFeatureDetector::getBatchSize(int faces) const {
+    int batch = 1;
+    while (batch < faces && batch < maxBatchSize) {
+        batch *= 2;
+    }
+    return std::min(batch, maxBatchSize);
 }
 
 void TFLiteFacialFeatureDetector::run(Image& image) {
 
     // original image width and height
     auto imgSize = image.getImageSize();
+
+    const auto& faceBboxes = image.getImage_faceBboxesRef();
+    const size_t numFaces = faceBboxes.size();
+
+    // input elements per face: H x W x 3
+    const size_t inputSizePerFace = static_cast<size_t>(net_inputSize.area()) * 3;
     
-    std::vector<FacialFeatures> vFeatures;
-    for (const auto& [faceBox, conf] : image.getImage_faceBboxes()) {
+    // face records are written straight into the image (one per face)
+    auto& vFeatures = image.getFacialFeaturesRef();
+    vFeatures.clear();
+    image.getLandmarkBuffer().clear();
+    image.getLandmarkBuffer().reserve(numFaces * TFLite_numFaceLandmarks);
+    vFeatures.reserve(numFaces);
+
+    // per-batch scratch (reused across images)
+    newFaceBoxes.resize(maxBatchSize);
+    pad_infos.resize(maxBatchSize);
+
+    // faces are processed in batches of (up to) maxBatchSize faces per Invoke
+    for (size_t first = 0; first < numFaces; first += maxBatchSize) {
         
-        // increase face box margin by 25% on each side
-        auto newFaceBox = increaseFaceMargin(faceBox, imgSize, margin);
-
-        /// preprocess image
-        // 1. resize face image to fit model's input size (e.g., 192x192)
-        cv::Mat faceMat;
-        std::vector<float> pad_info = image.resizeImage(newFaceBox, faceMat, net_inputSize, true); // padded resize
-
-        // 2. rearrange channels to RGB
-        cv::cvtColor(faceMat, faceMat, cv::COLOR_BGR2RGB);
-
-        // 3. convert CV_8UC3 pixel values to CV_32FC3
-        //    normalized between (-1, 1)
-        float inputNorm_mean =  127.5f;
-        float inputNorm_std  =  127.5f;
-        faceMat.convertTo(faceMat, CV_32FC3, 1 / inputNorm_std, - inputNorm_mean / inputNorm_std);
-
-        // 4. Fill input/output buffers
-        faceMeshNet_inputLayer = interpreter->typed_input_tensor<float>(0);
-        faceMeshNet_outputLayer = interpreter->typed_output_tensor<float>(0);
-        std::memcpy(faceMeshNet_inputLayer, faceMat.data, faceMat.total() * faceMat.elemSize());
-
-        /// Run inference
-        if (interpreter->Invoke() != kTfLiteOk){
+        // stop early (partial results) once the deadline has passed
+        if (image.isBudgetExhausted()) {
+            image.markPartial(getName());
+            break;
+        }
+
+        const int batch = static_cast<int>(std::min<size_t>(maxBatchSize, numFaces - first));
+        const int batchSize = getBatchSize(batch);
+        tflite::Interpreter& interpreter = getInterpreter(batchSize);
+
+        // input buffer holds all faces of the batch: [batchSize, H, W, 3]
+        faceMeshNet_inputLayer = interpreter.typed_input_tensor<float>(0);
+
+        for (int b = 0; b < batch; ++b) {
+            
+            const cv::Rect& faceBox = faceBboxes[first + b].first;
+
+            // increase face box margin by 25% on each side
+            newFaceBoxes[b] = increaseFaceMargin(faceBox, imgSize, margin);
+
+            /// preprocess image (single pass, straight into slot b of the input batch)
+            // 1. resize face image to fit model's input size (e.g., 192x192)
+            // 2. rearrange channels to RGB
+            // 3. normalize pixel values between (-1, 1)
+            pad_infos[b] = preprocessor.run(image.getImage_Region(newFaceBoxes[b]),
+                                            faceMeshNet_inputLayer + b * inputSizePerFace);
+        }
+
+        // unused slots of the batch
+        std::fill(faceMeshNet_inputLayer + batch * inputSizePerFace,
+                  faceMeshNet_inputLayer + batchSize * inputSizePerFace, 0.0f);
+
+        /// Run inference (all faces in the batch at once)
+        if (interpreter.Invoke() != kTfLiteOk){
             throw std::runtime_error("Facial Features Detection Task"
                     "-- Failed to invoke the TFLite model interpreter."); 
         }
 
         /// Post process
         // Read output buffers
-        std::vector<cv::Point> landmarks;
-        for (int i = 0; i < TFLite_numFaceLandmarks; ++i) {
-            
-            // get face landmark i from output layer 
-            cv::Point point = getFaceLandmarkAt(i, faceMeshNet_outputLayer);
-            
-            // scale feature points to original image
-            scaleCoordinates(point, pad_info[0], pad_info[1], pad_info[2], newFaceBox.size());
+        faceMeshNet_outputLayer = interpreter.typed_output_tensor<float>(0);
+        const size_t outputSizePerFace = interpreter.output_tensor(0)->bytes / sizeof(float) / batchSize;
+
+        for (int b = 0; b < batch; ++b) {
             
-            landmarks.push_back(point + newFaceBox.tl());
-        }
+            float* faceOutput = faceMeshNet_outputLayer + b * outputSizePerFace;
+            const ImagePreprocessor::PadInfo& pad_info = pad_infos[b];
 
-        // extract main facial landmarks (e.g., eye, nose, lips corners)
-        FacialFeatures features;
-        features.setFaceBbox(std::make_pair(faceBox, conf));
-        features.setFFeaturesFromTFLite(landmarks);
+            landmarks.clear();
+            for (int i = 0; i < TFLite_numFaceLandmarks; ++i) {
+                
+                // get face landmark i from output layer 
+                cv::Point point = getFaceLandmarkAt(i, faceOutput);
+                
+                // scale feature points to original image
+                scaleCoordinates(point, pad_info.pad_w, pad_info.pad_h, pad_info.scale, newFaceBoxes[b].size());
+                
+                landmarks.push_back(point + newFaceBoxes[b].tl());
+            }
 
-        vFeatures.push_back(features);
+            // extract main facial landmarks (e.g., eye, nose, lips corners)
+            FacialFeatures features;
+            features.setFaceBbox(faceBboxes[first + b]);
+            features.setFFeaturesFromTFLite(landmarks, image.getLandmarkBuffer());
+
+            vFeatures.push_back(features);
+        }
     }
-    // Keep Facial Features with image
-    image.setFacialFeatures(vFeatures);
 }
 
 cv::Rect TFLiteFacialFeatureDetector::increaseFaceMargin(const cv::Rect& faceBox, 
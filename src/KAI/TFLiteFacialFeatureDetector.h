@@ -6,12 +6,18 @@
 #include "tensorflow/lite/kernels/register.h"
 #include "tensorflow/lite/model_builder.h"
 #include "tensorflow/lite/optional_debug_tools.h"
+#ifdef KAI_TFLITE_XNNPACK
+#include "tensorflow/lite/delegates/xnnpack/xnnpack_delegate.h"
+#endif
 
 #include "KAITaskInterface.h"
+#include "ImagePreprocessor.h"
 #include "FacialFeatures.h"
 #include "Types.h"
 
+#include <memory>
 #include <string>
+#include <vector>
 
 class TFLiteFacialFeatureDetector: public KAITask {
 public:
@@ -23,8 +29,10 @@ public:
     TFLiteFacialFeatureDetector(const std::string& modelPath);
     
     /**
-     * @brief 
-     * 
+     * @brief Read task specific params
+     * @note  "NumThreads"  (int) - interpreter (and XNNPACK) threads; -1: TFLite default
+     *        "UseXNNPACK"  (int) - 1: run the model with the XNNPACK delegate
+     *        "BatchFaces"  (int) - max. number of faces per Invoke (1: no batching)
      * @param params 
      */
     void init(const std::map<std::string, Type> params);
@@ -35,6 +43,27 @@ public:
      * @param image 
      */
     void run(Image& image) override;
+
+    /**
+     * @brief Interpreter (and XNNPACK) threads from the threading policy
+     * @note  ignored if "NumThreads" is set in the task params
+     */
+    void setIntraOpThreads(int threads) override;
+
+    /**
+     * @brief auto-tuner: XNNPACK on/off x interpreter threads x faces per Invoke
+     * @note  settings given in the task params ("NumThreads", "UseXNNPACK", "BatchFaces") are kept
+     */
+    std::vector<KAIExecConfig> getExecCandidates() const override;
+    void setExecConfig(const KAIExecConfig& config) override;
+    void runSynthetic(int batchSize) override;
+
+    // warm-up of every batch size the faces of an image may use
+    // (falls back to one face per Invoke if the model does not accept the batch size)
+    void warmUp(int runs) override;
+
+    // interpreters of all batch sizes and the scratch buffers are built at load time
+    bool isAllocationFree() const override {return true;}
     
 private:
     
@@ -42,13 +71,33 @@ private:
     // network params
     //////////////////
     
-    // Flatbuffer model loader
-    std::unique_ptr<tflite::FlatBufferModel> faceMeshNet_;
-    
-    // Note: all Interpreters should be built with the InterpreterBuilder,
-    // which allocates memory for the Interpreter and does various set up
-    // tasks so that the Interpreter can read the provided model.
-    std::unique_ptr<tflite::Interpreter> interpreter;
+    // Flatbuffer model (immutable, shared by all pipelines)
+    std::shared_ptr<const tflite::FlatBufferModel> faceMeshNet_;
+
+    // interpreter for one batch size (input [batchSize, H, W, 3])
+    struct BatchInterpreter {
+#ifdef KAI_TFLITE_XNNPACK
+        // XNNPACK delegate (must outlive the interpreter, so it is declared first)
+        std::unique_ptr<TfLiteDelegate, void(*)(TfLiteDelegate*)> xnnpackDelegate{nullptr, TfLiteXNNPackDelegateDelete};
+#endif
+        // Note: all Interpreters should be built with the InterpreterBuilder,
+        // which allocates memory for the Interpreter and does various set up
+        // tasks so that the Interpreter can read the provided model.
+        std::unique_ptr<tflite::Interpreter> interpreter;
+        int batchSize = 1;
+    };
+
+    // one interpreter per batch size (1, 2, 4, ... up to maxBatchSize), all built at load time:
+    // batches never build, resize or reallocate anything at run time
+    std::vector<std::unique_ptr<BatchInterpreter>> interpreters;
+
+    // interpreter settings
+    int numThreads = -1;       // -1: let TFLite decide
+    bool numThreadsFromParams = false; // "NumThreads" overrides the threading policy
+    bool useXNNPACKFromParams = false; // not auto-tuned
+    bool batchSizeFromParams = false;  // not auto-tuned
+    bool useXNNPACK = false;   // apply XNNPACK delegate
+    int maxBatchSize = 1;      // max. faces per Invoke
 
     float* faceMeshNet_inputLayer;
     float* faceMeshNet_outputLayer;
@@ -62,9 +111,40 @@ private:
     // margin value (in percentage) to increase face box on each side
     float margin = 0.25;
 
+    // fused preprocessing: padded resize, BGR->RGB, normalize to (-1, 1), NHWC
+    ImagePreprocessor preprocessor;
+
+    // scratch buffers (reused across batches and images)
+    std::vector<cv::Rect> newFaceBoxes;                 // margin-padded face boxes of a batch
+    std::vector<ImagePreprocessor::PadInfo> pad_infos;  // preprocessing of each face of a batch
+    std::vector<cv::Point> landmarks;                   // landmarks of one face
+
     ///////////////////
     // Helper functions
     ///////////////////
+
+    // drop the interpreters and build those of all batch sizes with the current threading/delegate settings
+    void buildInterpreter();
+
+    // build the missing interpreters of the batch sizes getBatchSize() can return
+    // (batching is disabled if the model does not accept one of them)
+    void buildBatchInterpreters();
+
+    // interpreter of batch size <batch> (built if needed; throws if the model does not accept it)
+    tflite::Interpreter& getInterpreter(int batch);
+
+    // release the interpreters of batch sizes above maxBatchSize
+    void dropUnusedInterpreters();
+
+    // batch size used for <faces> faces: next power of two, at most maxBatchSize
+    // (unused slots are zero-filled)
+    int getBatchSize(int faces) const;
+
+    // model does not accept batches of maxBatchSize faces: one face per Invoke
+    void disableBatching(const std::exception& e);
+
+    // update preprocessor with the current network params
+    void setupPreprocessor();
     
     /**
      * @brief Increase face box margin on each side
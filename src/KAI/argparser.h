@@ -1,4 +1,6 @@
+#include <algorithm>
 #include <fstream>
+#include <vector>
 #include <opencv2/opencv.hpp>
 #include <nlohmann/json.hpp>
 #include <sys/stat.h>
@@ -10,6 +12,36 @@ using json = nlohmann::json;
 std::string outputPath;
 std::string jsonPath;
 std::string imagePath;
+int deadlineMs = 0; // per-image latency budget in ms (0: no deadline)
+bool serveMode = false; // run as HTTP inference server
+int servePort = 0;
+int ioThreads = 0;      // > 0: event-driven (epoll) server with <ioThreads> I/O threads
+int computeThreads = 1; // request processing threads (event-driven server)
+int maxBodyMB = 64;     // max. request body (encoded image) size of the HTTP server (MB)
+bool shmMode = false;   // serve a shared-memory ingest channel
+std::string shmName;
+int shmSlots = 4;       // ring size
+int shmSlotMB = 64;     // max. frame size per slot (MB)
+bool batchMode = false; // process all images of a folder
+std::string batchInputDir;
+std::string batchOutputDir;
+int batchReadThreads = 1;       // batch stage sizes
+int batchDecodeThreads = 2;
+int batchInferInstances = 1;
+int batchEncodeThreads = 1;
+int batchWriteThreads = 1;
+int batchQueueDepth = 4;
+int memoryBudgetMB = 0; // memory for images in flight (0: unlimited)
+int streamMP = 0;       // JPEGs with >= streamMP megapixels are decoded in strips (0: off)
+int numCores = 0;       // cores used by KAI (0: all available)
+int intraOpThreads = 0; // threads per task (0: cores / parallel images)
+bool pinThreads = false; // pin workers to their cores
+bool numaLocal = false;  // keep each worker's cores on one NUMA node
+std::string autoTuneCache; // auto-tune tasks at startup, decisions cached in this file
+int warmUpRuns = 1;     // synthetic inference runs per task at load time (0: none)
+std::string modelCacheDir; // pre-parsed models memory-mapped by all KAI processes
+bool watchConfig = false; // reload the MLConfig when the file changes (server modes)
+std::string requestedTasks; // outputs to compute, e.g. "FaceDetection,Smile" (empty: all tasks)
 
 //////////////////////
 // heler functions
@@ -27,12 +59,459 @@ bool isDirectory(const std::string& path) {
     return (buffer.st_mode & S_IFDIR) != 0;
 }
 
+// Read optional arguments argv[first..]
+int parseOptions(int first, int argc, char** argv){
+    
+    Logger& logger = Logger::getInstance();
+
+    // options followed by a value
+    static const std::vector<std::string> valueOptions = {
+        "-deadline", "-tasks", "-io_threads", "-compute_threads", "-max_body_mb", "-shm_slots", "-shm_slot_mb",
+        "-memory_budget_mb", "-stream_mp", "-cores", "-intra_threads", "-autotune", "-warmup_runs",
+        "-model_cache", "-read_threads", "-decode_threads", "-infer_instances", "-encode_threads",
+        "-write_threads", "-queue_depth"
+    };
+
+    for (int i = first; i < argc; ++i) {
+        std::string arg = argv[i];
+
+        if (i + 1 >= argc && std::find(valueOptions.begin(), valueOptions.end(), arg) != valueOptions.end()) {
+            std::string msg = "[KAI Task Manager]-- Error: missing value for " + arg + "!";
+
+            // logging
+            logger.log(ERROR, msg);
+
+            std::cerr << msg << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        // -deadline <ms>: latency budget for processing the image
+        if (arg == "-deadline" && i + 1 < argc) {
+            try {
+                deadlineMs = std::stoi(argv[++i]);
+            }
+            catch (const std::exception&) {
+                std::string msg = "[KAI Task Manager]-- Error: invalid value for -deadline (expected ms)!";
+
+                // logging
+                logger.log(ERROR, msg);
+
+                std::cerr << msg << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+        // -tasks <name,...>: compute these outputs only (and their prerequisite tasks)
+        else if (arg == "-tasks" && i + 1 < argc) {
+            requestedTasks = argv[++i];
+        }
+        // -io_threads <n>: serve with the event-driven (epoll) reactor
+        // -compute_threads <n>: request processing threads for the reactor
+        else if ((arg == "-io_threads" || arg == "-compute_threads") && i + 1 < argc) {
+            int value = 0;
+            try {
+                value = std::stoi(argv[++i]);
+            }
+            catch (const std::exception&) {
+                value = 0;
+            }
+
+            if (value <= 0) {
+                std::string msg = "[KAI Task Manager]-- Error: invalid value for " + arg + "!";
+
+                // logging
+                logger.log(ERROR, msg);
+
+                std::cerr << msg << std::endl;
+                return EXIT_FAILURE;
+            }
+
+            if (arg == "-io_threads") {
+                ioThreads = value;
+            }
+            else {
+                computeThreads = value;
+            }
+        }
+        // -max_body_mb <MB>: largest accepted upload (e.g., 20-50 MP JPEGs)
+        else if (arg == "-max_body_mb" && i + 1 < argc) {
+            try {
+                maxBodyMB = std::stoi(argv[++i]);
+            }
+            catch (const std::exception&) {
+                maxBodyMB = 0;
+            }
+
+            if (maxBodyMB <= 0 || maxBodyMB > 4095) {
+                std::string msg = "[KAI Task Manager]-- Error: invalid value for -max_body_mb (1-4095 MB)!";
+
+                // logging
+                logger.log(ERROR, msg);
+
+                std::cerr << msg << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+        // -shm_slots <n>, -shm_slot_mb <MB>: shared-memory channel size
+        else if ((arg == "-shm_slots" || arg == "-shm_slot_mb") && i + 1 < argc) {
+            int value = 0;
+            try {
+                value = std::stoi(argv[++i]);
+            }
+            catch (const std::exception&) {
+                value = 0;
+            }
+
+            if (value <= 0) {
+                std::string msg = "[KAI Task Manager]-- Error: invalid value for " + arg + "!";
+
+                // logging
+                logger.log(ERROR, msg);
+
+                std::cerr << msg << std::endl;
+                return EXIT_FAILURE;
+            }
+
+            if (arg == "-shm_slots") {
+                shmSlots = value;
+            }
+            else {
+                shmSlotMB = value;
+            }
+        }
+        // -memory_budget_mb <MB>: admit images while their estimated memory fits
+        else if (arg == "-memory_budget_mb" && i + 1 < argc) {
+            try {
+                memoryBudgetMB = std::stoi(argv[++i]);
+            }
+            catch (const std::exception&) {
+                memoryBudgetMB = -1;
+            }
+
+            if (memoryBudgetMB < 0) {
+                std::string msg = "[KAI Task Manager]-- Error: invalid value for -memory_budget_mb!";
+
+                // logging
+                logger.log(ERROR, msg);
+
+                std::cerr << msg << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+        // -stream_mp <MP>: decode very large JPEGs in strips (keeps a preview + face regions)
+        else if (arg == "-stream_mp" && i + 1 < argc) {
+            try {
+                streamMP = std::stoi(argv[++i]);
+            }
+            catch (const std::exception&) {
+                streamMP = -1;
+            }
+
+            if (streamMP < 0) {
+                std::string msg = "[KAI Task Manager]-- Error: invalid value for -stream_mp!";
+
+                // logging
+                logger.log(ERROR, msg);
+
+                std::cerr << msg << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+        // -cores <n>, -intra_threads <n>: threading policy (cores split between parallel images)
+        else if ((arg == "-cores" || arg == "-intra_threads") && i + 1 < argc) {
+            int value = 0;
+            try {
+                value = std::stoi(argv[++i]);
+            }
+            catch (const std::exception&) {
+                value = 0;
+            }
+
+            if (value <= 0) {
+                std::string msg = "[KAI Task Manager]-- Error: invalid value for " + arg + "!";
+
+                // logging
+                logger.log(ERROR, msg);
+
+                std::cerr << msg << std::endl;
+                return EXIT_FAILURE;
+            }
+
+            if (arg == "-cores") {
+                numCores = value;
+            }
+            else {
+                intraOpThreads = value;
+            }
+        }
+        // -autotune <cache.json>: benchmark execution settings per task at startup (cached per CPU model)
+        else if (arg == "-autotune" && i + 1 < argc) {
+            autoTuneCache = argv[++i];
+        }
+        // -warmup_runs <n>: synthetic inference runs per task at load time (0: no warm-up)
+        else if (arg == "-warmup_runs" && i + 1 < argc) {
+            try {
+                warmUpRuns = std::stoi(argv[++i]);
+            }
+            catch (const std::exception&) {
+                warmUpRuns = -1;
+            }
+
+            if (warmUpRuns < 0) {
+                std::string msg = "[KAI Task Manager]-- Error: invalid value for -warmup_runs!";
+
+                // logging
+                logger.log(ERROR, msg);
+
+                std::cerr << msg << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+        // -model_cache <dir>: pre-parsed models shared (memory-mapped) by all KAI processes
+        else if (arg == "-model_cache" && i + 1 < argc) {
+            modelCacheDir = argv[++i];
+
+            if (!isDirectory(modelCacheDir)) {
+                std::string msg = "[KAI Task Manager]-- Error: model cache directory does not exist!";
+
+                // logging
+                logger.log(ERROR, msg);
+
+                std::cerr << msg << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+        // -watch_config: hot reload of the MLConfig when the file changes
+        else if (arg == "-watch_config") {
+            watchConfig = true;
+        }
+        // -pin_threads: pin each worker to its own cores
+        else if (arg == "-pin_threads") {
+            pinThreads = true;
+        }
+        // -numa: pinned workers stay on one NUMA node
+        else if (arg == "-numa") {
+            pinThreads = true;
+            numaLocal = true;
+        }
+        // -read_threads, -decode_threads, -infer_instances, -encode_threads, -write_threads <n>,
+        // -queue_depth <n>: batch stage sizes
+        else if ((arg == "-read_threads" || arg == "-decode_threads" || arg == "-infer_instances" ||
+                  arg == "-encode_threads" || arg == "-write_threads" || arg == "-queue_depth") && i + 1 < argc) {
+            int value = 0;
+            try {
+                value = std::stoi(argv[++i]);
+            }
+            catch (const std::exception&) {
+                value = 0;
+            }
+
+            if (value <= 0) {
+                std::string msg = "[KAI Task Manager]-- Error: invalid value for " + arg + "!";
+
+                // logging
+                logger.log(ERROR, msg);
+
+                std::cerr << msg << std::endl;
+                return EXIT_FAILURE;
+            }
+
+            if (arg == "-read_threads") {
+                batchReadThreads = value;
+            }
+            else if (arg == "-decode_threads") {
+                batchDecodeThreads = value;
+            }
+            else if (arg == "-infer_instances") {
+                batchInferInstances = value;
+            }
+            else if (arg == "-encode_threads") {
+                batchEncodeThreads = value;
+            }
+            else if (arg == "-write_threads") {
+                batchWriteThreads = value;
+            }
+            else {
+                batchQueueDepth = value;
+            }
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
+
+int parseShmArguments(int argc, char** argv){
+    
+    Logger& logger = Logger::getInstance();
+
+    if (argc < 4) {
+        std::string msg = "[KAI Task Manager]-- Usage: " + std::string(argv[0]) + " -shm <name> <json_path>";
+
+        // logging
+        logger.log(ERROR, msg);
+
+        std::cerr << msg << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    shmMode = true;
+
+    // shm object name (POSIX names start with '/')
+    shmName = argv[2];
+    if (shmName.empty() || shmName[0] != '/') {
+        shmName = "/" + shmName;
+    }
+
+    // Read JSON file
+    jsonPath = argv[3];
+
+    if (!fileExists(jsonPath)) {
+        std::string msg = "[KAI Task Manager]-- Error: Could not open the MLConfig JSON file!";
+
+        // logging
+        logger.log(ERROR, msg);
+        
+        std::cerr << msg << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Read optional arguments (e.g., -shm_slots, -shm_slot_mb, -deadline)
+    return parseOptions(4, argc, argv);
+}
+
+int parseBatchArguments(int argc, char** argv){
+    
+    Logger& logger = Logger::getInstance();
+
+    if (argc < 5) {
+        std::string msg = "[KAI Task Manager]-- Usage: " + std::string(argv[0]) + " -batch <input_dir> <json_path> <output_dir>";
+
+        // logging
+        logger.log(ERROR, msg);
+
+        std::cerr << msg << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    batchMode = true;
+
+    // Read input folder
+    batchInputDir = argv[2];
+
+    if (!isDirectory(batchInputDir)) {
+        std::string msg = "[KAI Task Manager]-- Error: Could not open the input folder!";
+
+        // logging
+        logger.log(ERROR, msg);
+
+        std::cerr << msg << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Read JSON file
+    jsonPath = argv[3];
+
+    if (!fileExists(jsonPath)) {
+        std::string msg = "[KAI Task Manager]-- Error: Could not open the MLConfig JSON file!";
+
+        // logging
+        logger.log(ERROR, msg);
+        
+        std::cerr << msg << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Read output folder (created if needed)
+    batchOutputDir = argv[4];
+
+    if (!isDirectory(batchOutputDir) && mkdir(batchOutputDir.c_str(), 0755) != 0) {
+        std::string msg = "[KAI Task Manager]-- Error: Could not create the output folder!";
+
+        // logging
+        logger.log(ERROR, msg);
+
+        std::cerr << msg << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Read optional arguments (e.g., stage sizes, -deadline)
+    return parseOptions(5, argc, argv);
+}
+
+int parseServeArguments(int argc, char** argv){
+    
+    Logger& logger = Logger::getInstance();
+
+    if (argc < 4) {
+        std::string msg = "[KAI Task Manager]-- Usage: " + std::string(argv[0]) + " -serve <port> <json_path>";
+
+        // logging
+        logger.log(ERROR, msg);
+
+        std::cerr << msg << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    serveMode = true;
+
+    // Read listening port
+    try {
+        servePort = std::stoi(argv[2]);
+    }
+    catch (const std::exception&) {
+        servePort = 0;
+    }
+
+    if (servePort <= 0 || servePort > 65535) {
+        std::string msg = "[KAI Task Manager]-- Error: invalid port for -serve!";
+
+        // logging
+        logger.log(ERROR, msg);
+
+        std::cerr << msg << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Read JSON file
+    jsonPath = argv[3];
+
+    if (!fileExists(jsonPath)) {
+        std::string msg = "[KAI Task Manager]-- Error: Could not open the MLConfig JSON file!";
+
+        // logging
+        logger.log(ERROR, msg);
+        
+        std::cerr << msg << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Read optional arguments (e.g., default -deadline for requests)
+    return parseOptions(4, argc, argv);
+}
+
 int parseArguments(int argc, char** argv){
     
     Logger& logger = Logger::getInstance();
 
+    // Server mode: KAI-impl -serve <port> <json_path> [options]
+    if (argc > 1 && std::string(argv[1]) == "-serve") {
+        return parseServeArguments(argc, argv);
+    }
+
+    // Shared-memory mode: KAI-impl -shm <name> <json_path> [options]
+    if (argc > 1 && std::string(argv[1]) == "-shm") {
+        return parseShmArguments(argc, argv);
+    }
+
+    // Batch mode: KAI-impl -batch <input_dir> <json_path> <output_dir> [options]
+    if (argc > 1 && std::string(argv[1]) == "-batch") {
+        return parseBatchArguments(argc, argv);
+    }
+
     if (argc < 3) {
-        std::string msg = "[KAI Task Manager]-- Usage: " + std::string(argv[0]) + " <image_path> <json_path>";
+        std::string msg = "[KAI Task Manager]-- Usage: " + std::string(argv[0]) + " <image_path> <json_path>"
+                          "\n                        " + std::string(argv[0]) + " -batch <input_dir> <json_path> <output_dir>"
+                          "\n                        " + std::string(argv[0]) + " -serve <port> <json_path>"
+                          "\n                        " + std::string(argv[0]) + " -shm <name> <json_path>";
 
         // logging
         logger.log(ERROR, msg);
@@ -69,10 +548,14 @@ int parseArguments(int argc, char** argv){
     }
 
     // Read output path for image
-    outputPath = argv[3];
+    if (argc > 3) {
+        outputPath = argv[3];
+    }
 
-    // TODO: arg parse option for batch processing
-    //       e.g., provide folder and image extensions to process
+    // Read optional arguments
+    if (parseOptions(4, argc, argv)) {
+        return EXIT_FAILURE;
+    }
 
     return EXIT_SUCCESS;
 }
@@ -87,4 +570,124 @@ std::string parser_getJSONPath(){
 
 std::string parser_getOutputPath(){
     return outputPath;
-}
\ No newline at end of file
+}
+
+int parser_getDeadlineMs(){
+    return deadlineMs;
+}
+
+bool parser_isServeMode(){
+    return serveMode;
+}
+
+int parser_getServePort(){
+    return servePort;
+}
+
+int parser_getIOThreads(){
+    return ioThreads;
+}
+
+int parser_getComputeThreads(){
+    return computeThreads;
+}
+
+int parser_getMaxBodyMB(){
+    return maxBodyMB;
+}
+
+bool parser_isShmMode(){
+    return shmMode;
+}
+
+std::string parser_getShmName(){
+    return shmName;
+}
+
+int parser_getShmSlots(){
+    return shmSlots;
+}
+
+int parser_getShmSlotMB(){
+    return shmSlotMB;
+}
+
+bool parser_isBatchMode(){
+    return batchMode;
+}
+
+std::string parser_getBatchInputDir(){
+    return batchInputDir;
+}
+
+std::string parser_getBatchOutputDir(){
+    return batchOutputDir;
+}
+
+int parser_getBatchReadThreads(){
+    return batchReadThreads;
+}
+
+int parser_getBatchDecodeThreads(){
+    return batchDecodeThreads;
+}
+
+int parser_getBatchInferInstances(){
+    return batchInferInstances;
+}
+
+int parser_getBatchEncodeThreads(){
+    return batchEncodeThreads;
+}
+
+int parser_getBatchWriteThreads(){
+    return batchWriteThreads;
+}
+
+int parser_getBatchQueueDepth(){
+    return batchQueueDepth;
+}
+
+int parser_getMemoryBudgetMB(){
+    return memoryBudgetMB;
+}
+
+int parser_getStreamMP(){
+    return streamMP;
+}
+
+int parser_getNumCores(){
+    return numCores;
+}
+
+int parser_getIntraOpThreads(){
+    return intraOpThreads;
+}
+
+bool parser_isPinThreads(){
+    return pinThreads;
+}
+
+bool parser_isNumaLocal(){
+    return numaLocal;
+}
+
+std::string parser_getAutoTuneCache(){
+    return autoTuneCache;
+}
+
+int parser_getWarmUpRuns(){
+    return warmUpRuns;
+}
+
+std::string parser_getModelCacheDir(){
+    return modelCacheDir;
+}
+
+bool parser_isWatchConfig(){
+    return watchConfig;
+}
+
+std::string parser_getRequestedTasks(){
+    return requestedTasks;
+}
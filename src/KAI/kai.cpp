@@ -0,0 +1,338 @@
+#include "kai.h"
+
+#include <opencv2/imgcodecs.hpp>
+#include <opencv2/imgproc.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "KAIPriorityScheduler.h"
+#include "KAITaskManager.h"
+#include "KAIResults.h"
+
+struct kai_pipeline {
+    // independent task managers (tasks own their inference state)
+    std::vector<std::unique_ptr<KAITaskManager>> instances;
+
+    // lends instances to images (slot: instance index)
+    std::unique_ptr<KAIPriorityScheduler> scheduler;
+};
+
+// copied out of the image (the image, its frame and the caller's pixels are released
+// when kai_pipeline_process* returns)
+struct kai_result {
+    std::vector<kai_face> faces;
+    std::vector<float> landmarksX;   // feature points of all faces (kai_face points into them)
+    std::vector<float> landmarksY;
+    bool partial = false;
+    std::string json;
+};
+
+namespace {
+    thread_local std::string lastError;
+    thread_local KAIPriority threadPriority = KAIPriority::Interactive;
+
+    kai_status fail(kai_status status, const std::string& message) {
+        lastError = message;
+        return status;
+    }
+
+    struct ProcessOptions {
+        int deadlineMs = 0;
+        std::vector<std::string> tasks; // requested outputs (empty: all tasks)
+    };
+
+    // caller's options (fields beyond its struct_size keep their defaults)
+    kai_status readOptions(kai_pipeline* pipeline, const kai_process_options* options,
+                           ProcessOptions& out) {
+        if (options == nullptr) {
+            return KAI_OK;
+        }
+
+        auto hasField = [options](size_t offset, size_t size) {
+            return options->struct_size >= offset + size;
+        };
+
+        if (hasField(offsetof(kai_process_options, deadline_ms), sizeof(options->deadline_ms))) {
+            out.deadlineMs = options->deadline_ms;
+        }
+        if (hasField(offsetof(kai_process_options, tasks), sizeof(options->tasks)) && options->tasks != nullptr) {
+            out.tasks = KAITaskManager::parseTaskList(options->tasks);
+            for (const auto& taskName : out.tasks) {
+                if (!pipeline->instances.front()->hasTask(taskName)) {
+                    return fail(KAI_ERROR_INVALID_ARGUMENT, "requested task " + taskName + " is not in the MLConfig");
+                }
+            }
+        }
+        return KAI_OK;
+    }
+
+    // run the pipeline on a BGR image and collect the results
+    kai_status runImage(kai_pipeline* pipeline, const cv::Mat& imgMat, const ProcessOptions& options,
+                        kai_result** result) {
+        Image image(imgMat, "kai");
+        if (options.deadlineMs > 0) {
+            image.setDeadline(Deadline(std::chrono::milliseconds(options.deadlineMs)));
+        }
+        image.setRequestedTasks(options.tasks);
+
+        {
+            // bulk images are paused between tasks while interactive images wait
+            KAIPriorityScheduler::Lease lease = pipeline->scheduler->acquire(threadPriority);
+            image.setTaskBoundaryHook([&lease] {lease.yieldPoint();});
+            pipeline->instances[lease.getSlot()]->runTasks(image);
+            image.setTaskBoundaryHook(nullptr);
+        }
+
+        std::unique_ptr<kai_result> res(new kai_result);
+        res->partial = image.isPartial();
+        res->json = imageResultsToJSON(image).dump();
+
+        // flatten results (feature points are copied: the result outlives the image)
+        const std::vector<FacialFeatures> features = image.getFacialFeatures();
+        if (features.empty()) {
+            // face detection only
+            for (const auto& faceBbox : image.getImage_faceBboxes()) {
+                kai_face face = {};
+                face.x = faceBbox.first.x;
+                face.y = faceBbox.first.y;
+                face.width = faceBbox.first.width;
+                face.height = faceBbox.first.height;
+                face.confidence = faceBbox.second;
+                res->faces.push_back(face);
+            }
+        }
+
+        size_t numLandmarks = 0;
+        for (const auto& fFeatures : features) {
+            numLandmarks += fFeatures.getFacialFeatures().size();
+        }
+        res->landmarksX.reserve(numLandmarks);
+        res->landmarksY.reserve(numLandmarks);
+
+        for (const auto& fFeatures : features) {
+            kai_face face = {};
+            const cv::Rect box = fFeatures.getFaceBbox();
+            face.x = box.x;
+            face.y = box.y;
+            face.width = box.width;
+            face.height = box.height;
+            face.confidence = fFeatures.getFaceConfidence();
+
+            // no reallocation (reserved above): the pointers stay valid
+            LandmarkView points = fFeatures.getFacialFeatures();
+            face.num_landmarks = static_cast<int>(points.size());
+            face.landmarks_x = res->landmarksX.data() + res->landmarksX.size();
+            face.landmarks_y = res->landmarksY.data() + res->landmarksY.size();
+            res->landmarksX.insert(res->landmarksX.end(), points.x(), points.x() + points.size());
+            res->landmarksY.insert(res->landmarksY.end(), points.y(), points.y() + points.size());
+
+            face.has_head_pose = fFeatures.hasAuxData(AuxData::eHeadPose);
+            if (face.has_head_pose) {
+                const HeadPose& headPose = fFeatures.getAuxData<HeadPose>();
+                face.roll = headPose.roll;
+                face.yaw = headPose.yaw;
+                face.pitch = headPose.pitch;
+            }
+            face.has_mouth_open = fFeatures.hasAuxData(AuxData::eMouthOpen);
+            face.mouth_open = fFeatures.isMouthOpen();
+            face.has_smile = fFeatures.hasAuxData(AuxData::eSmile);
+            face.smile = fFeatures.isSmileDetected();
+            face.has_eyeglasses = fFeatures.hasAuxData(AuxData::eEyeglasses);
+            face.eyeglasses = fFeatures.isEyeglassesDetected();
+
+            res->faces.push_back(face);
+        }
+
+        *result = res.release();
+        return KAI_OK;
+    }
+}
+
+const char* kai_version(void)
+{
+    return KAI_VERSION_STRING;
+}
+
+const char* kai_last_error(void)
+{
+    return lastError.c_str();
+}
+
+kai_status kai_pipeline_create(const char* mlconfig_path, int num_instances,
+                               kai_pipeline** pipeline)
+{
+    if (mlconfig_path == nullptr || pipeline == nullptr || num_instances < 1) {
+        return fail(KAI_ERROR_INVALID_ARGUMENT, "kai_pipeline_create: invalid argument");
+    }
+
+    try {
+        // cores are split between the instances (no oversubscription when all are busy)
+        KAIThreadingPolicy threading;
+        threading.interImageWorkers = num_instances;
+        threading.applyGlobal();
+
+        std::unique_ptr<kai_pipeline> p(new kai_pipeline);
+        for (int i = 0; i < num_instances; ++i) {
+            std::unique_ptr<KAITaskManager> manager(new KAITaskManager);
+            manager->setThreadingPolicy(threading);
+            manager->loadMLConfigs(mlconfig_path);
+            p->instances.push_back(std::move(manager));
+        }
+        p->scheduler.reset(new KAIPriorityScheduler(p->instances.size()));
+
+        *pipeline = p.release();
+        return KAI_OK;
+    }
+    catch (const std::exception& e) {
+        return fail(KAI_ERROR_LOAD, e.what());
+    }
+}
+
+void kai_pipeline_destroy(kai_pipeline* pipeline)
+{
+    delete pipeline;
+}
+
+void kai_set_thread_priority(kai_priority priority)
+{
+    threadPriority = (priority == KAI_PRIORITY_BULK) ? KAIPriority::Bulk : KAIPriority::Interactive;
+}
+
+kai_status kai_pipeline_process(kai_pipeline* pipeline, const uint8_t* pixels,
+                                int width, int height, size_t stride,
+                                kai_pixel_format format, int deadline_ms,
+                                kai_result** result)
+{
+    kai_process_options options = {sizeof(options), deadline_ms, nullptr};
+    return kai_pipeline_process_ex(pipeline, pixels, width, height, stride, format, &options, result);
+}
+
+kai_status kai_pipeline_process_ex(kai_pipeline* pipeline, const uint8_t* pixels,
+                                   int width, int height, size_t stride,
+                                   kai_pixel_format format, const kai_process_options* options,
+                                   kai_result** result)
+{
+    static const size_t bytesPerPixel[] = {3, 3, 4, 4, 1};
+    if (pipeline == nullptr || pixels == nullptr || result == nullptr || width <= 0 || height <= 0 ||
+        format < KAI_FORMAT_BGR8 || format > KAI_FORMAT_GRAY8 ||
+        stride < static_cast<size_t>(width) * bytesPerPixel[format]) {
+        return fail(KAI_ERROR_INVALID_ARGUMENT, "kai_pipeline_process: invalid argument");
+    }
+
+    try {
+        ProcessOptions processOptions;
+        kai_status status = readOptions(pipeline, options, processOptions);
+        if (status != KAI_OK) {
+            return status;
+        }
+
+        uint8_t* data = const_cast<uint8_t*>(pixels);
+
+        // wrap the caller's pixels (BGR8: no copy); the pipeline works on BGR images
+        cv::Mat imgMat;
+        switch (format) {
+            case KAI_FORMAT_BGR8:
+                imgMat = cv::Mat(height, width, CV_8UC3, data, stride);
+                break;
+            case KAI_FORMAT_RGB8:
+                cv::cvtColor(cv::Mat(height, width, CV_8UC3, data, stride), imgMat, cv::COLOR_RGB2BGR);
+                break;
+            case KAI_FORMAT_BGRA8:
+                cv::cvtColor(cv::Mat(height, width, CV_8UC4, data, stride), imgMat, cv::COLOR_BGRA2BGR);
+                break;
+            case KAI_FORMAT_RGBA8:
+                cv::cvtColor(cv::Mat(height, width, CV_8UC4, data, stride), imgMat, cv::COLOR_RGBA2BGR);
+                break;
+            case KAI_FORMAT_GRAY8:
+                cv::cvtColor(cv::Mat(height, width, CV_8UC1, data, stride), imgMat, cv::COLOR_GRAY2BGR);
+                break;
+        }
+
+        return runImage(pipeline, imgMat, processOptions, result);
+    }
+    catch (const std::exception& e) {
+        return fail(KAI_ERROR_RUNTIME, e.what());
+    }
+}
+
+kai_status kai_pipeline_process_encoded(kai_pipeline* pipeline, const void* data,
+                                        size_t size, int deadline_ms,
+                                        kai_result** result)
+{
+    kai_process_options options = {sizeof(options), deadline_ms, nullptr};
+    return kai_pipeline_process_encoded_ex(pipeline, data, size, &options, result);
+}
+
+kai_status kai_pipeline_process_encoded_ex(kai_pipeline* pipeline, const void* data,
+                                           size_t size, const kai_process_options* options,
+                                           kai_result** result)
+{
+    if (pipeline == nullptr || data == nullptr || size == 0 || result == nullptr) {
+        return fail(KAI_ERROR_INVALID_ARGUMENT, "kai_pipeline_process_encoded: invalid argument");
+    }
+
+    try {
+        ProcessOptions processOptions;
+        kai_status status = readOptions(pipeline, options, processOptions);
+        if (status != KAI_OK) {
+            return status;
+        }
+
+        cv::Mat buffer(1, static_cast<int>(size), CV_8UC1, const_cast<void*>(data));
+        cv::Mat imgMat = cv::imdecode(buffer, cv::IMREAD_COLOR);
+        if (imgMat.empty()) {
+            return fail(KAI_ERROR_DECODE, "kai_pipeline_process_encoded: could not decode the image");
+        }
+
+        return runImage(pipeline, imgMat, processOptions, result);
+    }
+    catch (const std::exception& e) {
+        return fail(KAI_ERROR_RUNTIME, e.what());
+    }
+}
+
+int kai_result_num_faces(const kai_result* result)
+{
+    return result == nullptr ? 0 : static_cast<int>(result->faces.size());
+}
+
+kai_status kai_result_get_face(const kai_result* result, int index, kai_face* face)
+{
+    // layout of 1.0 (fields are only appended)
+    static const size_t minFaceSize = offsetof(kai_face, eyeglasses) + sizeof(float);
+
+    if (result == nullptr || face == nullptr || index < 0 ||
+        index >= static_cast<int>(result->faces.size())) {
+        return fail(KAI_ERROR_INVALID_ARGUMENT, "kai_result_get_face: invalid argument");
+    }
+    if (face->struct_size < minFaceSize) {
+        return fail(KAI_ERROR_INVALID_ARGUMENT, "kai_result_get_face: struct_size is not set or too small");
+    }
+
+    // the caller's struct may be older (smaller) or newer (larger) than the library's
+    const size_t callerSize = face->struct_size;
+    std::memcpy(face, &result->faces[index], std::min(callerSize, sizeof(kai_face)));
+    face->struct_size = callerSize;
+    return KAI_OK;
+}
+
+int kai_result_is_partial(const kai_result* result)
+{
+    return (result != nullptr && result->partial) ? 1 : 0;
+}
+
+const char* kai_result_json(kai_result* result)
+{
+    // built with the result (no C++ exception can escape here)
+    return (result != nullptr) ? result->json.c_str() : "";
+}
+
+void kai_result_destroy(kai_result* result)
+{
+    delete result;
+}
@@ -0,0 +1,179 @@
+#ifndef KAI_H
+#define KAI_H
+
+/*
+ * libkai -- C API of the KAI (Kodak AI) face analysis pipeline
+ *
+ *  kai_pipeline* pipeline = NULL;
+ *  if (kai_pipeline_create("MLConfig_FD-FF.json", 2, &pipeline) != KAI_OK) {
+ *      fprintf(stderr, "%s\n", kai_last_error());
+ *  }
+ *
+ *  kai_result* result = NULL;
+ *  kai_pipeline_process(pipeline, pixels, width, height, stride, KAI_FORMAT_BGR8, 0, &result);
+ *  for (int i = 0; i < kai_result_num_faces(result); ++i) {
+ *      kai_face face;
+ *      face.struct_size = sizeof(face);
+ *      kai_result_get_face(result, i, &face);
+ *  }
+ *  kai_result_destroy(result);
+ *  kai_pipeline_destroy(pipeline);
+ *
+ * Thread safety: kai_pipeline_process* may be called concurrently on the same pipeline;
+ * up to <num_instances> images are processed in parallel (others wait for a free instance).
+ * Waiting images are served per traffic class (see kai_set_thread_priority).
+ * Results are independent objects and may be used from any thread.
+ *
+ * Versioning: the shared library's SOVERSION is KAI_VERSION_MAJOR (bumped on ABI breaks);
+ * structs filled by or passed to the library start with struct_size, so fields can be
+ * appended in minor versions without breaking callers built against older headers.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* version of this header (kai_version(): version of the loaded library) */
+#define KAI_VERSION_MAJOR 1
+#define KAI_VERSION_MINOR 0
+#define KAI_VERSION_PATCH 0
+#define KAI_VERSION_STRING "1.0.0"
+
+#if defined(__GNUC__)
+#define KAI_API __attribute__((visibility("default")))
+#else
+#define KAI_API
+#endif
+
+typedef struct kai_pipeline kai_pipeline;
+typedef struct kai_result kai_result;
+
+typedef enum {
+    KAI_OK = 0,
+    KAI_ERROR_INVALID_ARGUMENT,
+    KAI_ERROR_LOAD,        /* MLConfig or model could not be loaded */
+    KAI_ERROR_DECODE,      /* encoded image could not be decoded */
+    KAI_ERROR_RUNTIME      /* inference failed */
+} kai_status;
+
+/* traffic classes */
+typedef enum {
+    KAI_PRIORITY_INTERACTIVE = 0,  /* a user waits for the answer (default) */
+    KAI_PRIORITY_BULK              /* backfill, reprocessing: yields to interactive images
+                                      between tasks */
+} kai_priority;
+
+/* pixel formats (8 bits per channel) */
+typedef enum {
+    KAI_FORMAT_BGR8 = 0,   /* native format (no copy) */
+    KAI_FORMAT_RGB8,
+    KAI_FORMAT_BGRA8,
+    KAI_FORMAT_RGBA8,
+    KAI_FORMAT_GRAY8
+} kai_pixel_format;
+
+/* options of kai_pipeline_process_ex / kai_pipeline_process_encoded_ex */
+typedef struct {
+    size_t struct_size;    /* sizeof(kai_process_options): fields added in later versions
+                              are only read if the caller's struct has them */
+    int deadline_ms;       /* latency budget (0: none) */
+    const char* tasks;     /* outputs to compute, comma separated (e.g. "FaceDetection,Smile");
+                              NULL or "": all tasks (prerequisites run as needed) */
+} kai_process_options;
+
+typedef struct {
+    size_t struct_size;        /* set by the caller to sizeof(kai_face) */
+    int x, y, width, height;   /* face box (pixels) */
+    float confidence;
+
+    /* facial feature points, owned by the result */
+    int num_landmarks;
+    const float* landmarks_x;
+    const float* landmarks_y;
+
+    /* auxiliary data (has_* == 0 when not computed) */
+    int has_head_pose;
+    float roll, yaw, pitch;    /* degrees */
+    int has_mouth_open;
+    float mouth_open;
+    int has_smile;
+    float smile;
+    int has_eyeglasses;
+    float eyeglasses;
+} kai_face;
+
+/* version of the loaded library ("major.minor.patch") */
+KAI_API const char* kai_version(void);
+
+/* message of the last error on the calling thread */
+KAI_API const char* kai_last_error(void);
+
+/*
+ * load the tasks and models of an MLConfig JSON file
+ * num_instances: number of images that can be processed in parallel (>= 1)
+ * the available cores are split between the instances (sets OpenCV's thread count)
+ */
+KAI_API kai_status kai_pipeline_create(const char* mlconfig_path, int num_instances,
+                                       kai_pipeline** pipeline);
+
+KAI_API void kai_pipeline_destroy(kai_pipeline* pipeline);
+
+/* traffic class of the images processed by the calling thread */
+KAI_API void kai_set_thread_priority(kai_priority priority);
+
+/*
+ * process raw pixels (stride: bytes per row)
+ * pixels must stay valid during the call only
+ * deadline_ms: latency budget (0: none)
+ */
+KAI_API kai_status kai_pipeline_process(kai_pipeline* pipeline, const uint8_t* pixels,
+                                        int width, int height, size_t stride,
+                                        kai_pixel_format format, int deadline_ms,
+                                        kai_result** result);
+
+/* process an encoded image (jpg, png, ...) held in memory */
+KAI_API kai_status kai_pipeline_process_encoded(kai_pipeline* pipeline, const void* data,
+                                                size_t size, int deadline_ms,
+                                                kai_result** result);
+
+/*
+ * same with options (NULL: defaults), e.g. face boxes only:
+ *
+ *  kai_process_options options = {sizeof(options), 200, "FaceDetection"};
+ *  kai_pipeline_process_ex(pipeline, pixels, width, height, stride, KAI_FORMAT_BGR8, &options, &result);
+ *
+ * KAI_ERROR_INVALID_ARGUMENT if a requested task is not in the MLConfig
+ */
+KAI_API kai_status kai_pipeline_process_ex(kai_pipeline* pipeline, const uint8_t* pixels,
+                                           int width, int height, size_t stride,
+                                           kai_pixel_format format, const kai_process_options* options,
+                                           kai_result** result);
+
+KAI_API kai_status kai_pipeline_process_encoded_ex(kai_pipeline* pipeline, const void* data,
+                                                   size_t size, const kai_process_options* options,
+                                                   kai_result** result);
+
+KAI_API int kai_result_num_faces(const kai_result* result);
+
+/*
+ * copy face <index> into <face>; face->struct_size must be set by the caller
+ * (KAI_ERROR_INVALID_ARGUMENT if smaller than the 1.0 kai_face). Only the fields known to both
+ * sides are written: with an older library, newer fields keep the caller's values (zero-initialize).
+ */
+KAI_API kai_status kai_result_get_face(const kai_result* result, int index, kai_face* face);
+
+/* 1 if the deadline was reached (some tasks were skipped or cut short) */
+KAI_API int kai_result_is_partial(const kai_result* result);
+
+/* results as JSON (owned by the result) */
+KAI_API const char* kai_result_json(kai_result* result);
+
+KAI_API void kai_result_destroy(kai_result* result);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* KAI_H */
@@ -0,0 +1,149 @@
+// Allocation test: once the tasks are warmed up, processing an image must not allocate
+// (tasks reuse their input blobs, interpreters and scratch buffers; the image's records
+// live in its arena). The measured run uses a fresh Image, so nothing is left over from
+// the warm-up image.
+//
+//  KAI-alloc-test <MLConfig> <image> [<second image>]
+//
+// The warm-up run processes <image>; the measured run processes <second image> (default:
+// <image> again, in a new Image object).
+// Tasks whose inference library allocates per call (cv::dnn, dlib: KAITask::isAllocationFree
+// is false) are reported as known exceptions and do not fail the test.
+// Without a FaceDetection task in the MLConfig, the whole image is used as the face box,
+// so the per-face tasks can be checked on their own.
+
+#include <opencv2/imgcodecs.hpp>
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "KAITaskManager.h"
+#include "Logger.h"
+
+namespace {
+    std::atomic<bool> counting{false};
+    std::atomic<size_t> allocations{0};
+
+    void* allocate(size_t size) {
+        if (counting.load(std::memory_order_relaxed)) {
+            allocations.fetch_add(1, std::memory_order_relaxed);
+        }
+        void* p = std::malloc(size == 0 ? 1 : size);
+        if (p == nullptr) {
+            throw std::bad_alloc();
+        }
+        return p;
+    }
+
+    void* allocateAligned(size_t size, std::align_val_t alignment) {
+        if (counting.load(std::memory_order_relaxed)) {
+            allocations.fetch_add(1, std::memory_order_relaxed);
+        }
+        const size_t align = static_cast<size_t>(alignment);
+        void* p = std::aligned_alloc(align, (size + align - 1) / align * align);
+        if (p == nullptr) {
+            throw std::bad_alloc();
+        }
+        return p;
+    }
+}
+
+void* operator new(size_t size) {return allocate(size);}
+void* operator new[](size_t size) {return allocate(size);}
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    try {return allocate(size);} catch (...) {return nullptr;}
+}
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    try {return allocate(size);} catch (...) {return nullptr;}
+}
+void* operator new(size_t size, std::align_val_t alignment) {return allocateAligned(size, alignment);}
+void* operator new[](size_t size, std::align_val_t alignment) {return allocateAligned(size, alignment);}
+
+void operator delete(void* p) noexcept {std::free(p);}
+void operator delete[](void* p) noexcept {std::free(p);}
+void operator delete(void* p, size_t) noexcept {std::free(p);}
+void operator delete[](void* p, size_t) noexcept {std::free(p);}
+void operator delete(void* p, std::align_val_t) noexcept {std::free(p);}
+void operator delete[](void* p, std::align_val_t) noexcept {std::free(p);}
+void operator delete(void* p, size_t, std::align_val_t) noexcept {std::free(p);}
+void operator delete[](void* p, size_t, std::align_val_t) noexcept {std::free(p);}
+
+int main(int argc, char** argv)
+{
+    if (argc < 3) {
+        std::fprintf(stderr, "usage: %s <MLConfig> <image> [<second image>]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    // messages are not formatted when dropped
+    Logger::getInstance().setLevel(ERROR);
+
+    KAITaskManager manager;
+    manager.setWarmUpRuns(1);
+    manager.loadMLConfigs(argv[1]);
+
+    const char* warmUpPath = argv[2];
+    const char* measuredPath = (argc > 3) ? argv[3] : argv[2];
+    cv::Mat warmUpMat = cv::imread(warmUpPath, cv::IMREAD_COLOR);
+    cv::Mat measuredMat = cv::imread(measuredPath, cv::IMREAD_COLOR);
+    if (warmUpMat.empty() || measuredMat.empty()) {
+        std::fprintf(stderr, "could not read %s\n", warmUpMat.empty() ? warmUpPath : measuredPath);
+        return EXIT_FAILURE;
+    }
+
+    const bool detectFaces = manager.hasTask("FaceDetection");
+    const std::vector<std::shared_ptr<KAITask>> tasks = manager.getTasks();
+
+    // warm-up image (sizes the tasks' buffers)
+    {
+        Image img(warmUpMat, "alloc-test-warmup");
+        if (!detectFaces) {
+            img.setImage_faceBboxes({{cv::Rect(0, 0, warmUpMat.cols, warmUpMat.rows), 1.0f}});
+        }
+        manager.runTasks(img);
+    }
+
+    // measured image: a new Image object (set up before counting)
+    Image img(measuredMat, "alloc-test");
+    if (!detectFaces) {
+        img.setImage_faceBboxes({{cv::Rect(0, 0, measuredMat.cols, measuredMat.rows), 1.0f}});
+    }
+
+    // allocations up to each task boundary (one task per boundary, all tasks run)
+    size_t taskAllocations[32] = {};
+    size_t numTasks = 0;
+    img.setTaskBoundaryHook([&] {
+        if (numTasks + 1 < sizeof(taskAllocations) / sizeof(taskAllocations[0])) {
+            taskAllocations[numTasks++] = allocations.load();
+        }
+    });
+
+    counting = true;
+    manager.runTasks(img);
+    counting = false;
+    taskAllocations[numTasks++] = allocations.load();
+
+    size_t unexpected = 0;
+    size_t previous = 0;
+    for (size_t i = 0; i < numTasks; ++i) {
+        const size_t count = taskAllocations[i] - previous;
+        previous = taskAllocations[i];
+
+        const bool allocationFree = (i < tasks.size()) && tasks[i]->isAllocationFree();
+        const std::string name = (i < tasks.size()) ? tasks[i]->getName() : "?";
+        std::printf("%s: %zu allocation(s)%s\n", name.c_str(), count,
+                    (count > 0 && !allocationFree) ? " (known exception: inference library allocates)" : "");
+        if (allocationFree) {
+            unexpected += count;
+        }
+    }
+    std::printf("%zu face(s), %zu allocation(s), %zu unexpected\n",
+                img.getImage_faceBboxesRef().size(), allocations.load(), unexpected);
+
+    return unexpected == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}